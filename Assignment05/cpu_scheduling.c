@@ -3,195 +3,1151 @@
  * ===============
  * Implementation of CPU Scheduling Algorithms
  * 
- * This program simulates two popular CPU scheduling algorithms:
+ * This program simulates four CPU scheduling algorithms:
  * 1. SRTF (Shortest Remaining Time First)
  *    - Preemptive version of SJF (Shortest Job First)
  *    - Selects process with shortest remaining time
  *    - Can preempt running process if shorter job arrives
+ *    - Event-driven: ready processes live in a min-heap keyed on remaining
+ *      time, and the clock jumps straight to the next arrival or completion
  * 
  * 2. Round Robin (RR)
  *    - Each process gets fixed time quantum
  *    - Process is preempted if it exceeds quantum
  *    - Preempted process goes to end of ready queue
+ *    - Arrivals are admitted in arrival order into a circular ready queue,
+ *      and the clock jumps over idle gaps to the next arrival
+ *
+ * 3. CFS (Completely Fair Scheduler, modeled on Linux)
+ *    - Each process accumulates virtual runtime, scaled by its nice weight
+ *    - The process with the smallest vruntime runs next, picked from a
+ *      red-black tree in O(log n) (the leftmost node is cached)
+ *    - Time slices divide a target latency in proportion to weight
+ *
+ * 4. Priority (modeled on the Linux 2.6 O(1) scheduler)
+ *    - Static priority 100..139 comes from the nice value (120 + nice)
+ *    - One FIFO run queue per priority plus a bitmap of non-empty queues;
+ *      find-first-set picks the next process in constant time
+ *    - Preemptive, with priority-scaled time slices and periodic aging so
+ *      low-priority processes cannot starve
  * 
+ * Every algorithm is a SchedPolicy on the shared event-driven engine in
+ * sched_engine.h; --policy NAME (SRTF, RR, CFS, Priority) runs just one.
+ *
  * Performance Metrics Calculated:
  * - Completion Time: Time when process finishes
  * - Turnaround Time: Completion Time - Arrival Time
  * - Waiting Time: Turnaround Time - Burst Time
+ * - Response Time: First time on the CPU - Arrival Time (--summary)
+ *
+ * Input:
+ * - With no arguments, process details are entered interactively.
+ * - --trace FILE reads a memory-mapped CSV or binary trace (see workload.h).
+ * - --generate N creates N processes with Poisson arrivals and Pareto bursts
+ *   (--rate, --alpha, --min-burst, --seed tune it; --save FILE stores them).
+ * - --quantum Q sets the Round Robin quantum for non-interactive runs.
+ * - --summary replaces the per-process rows with mean, p50, p90, p99, p99.9
+ *   and max of response, waiting and turnaround time, kept in fixed-size
+ *   streaming histograms while the simulation runs.
+ *
+ * Parameter sweep:
+ * - --sweep QMIN QMAX [--step S] [--threads T] runs SRTF and CFS plus Round
+ *   Robin and Priority for every quantum in the range on a thread pool. All
+ *   workers share one read-only copy of the trace and the result is a
+ *   comparison table.
+ *
+ * Real-time mode:
+ * - --rt FILE | --rt-generate NTASKS UTIL [--jobs N] [--seed S] simulates a
+ *   set of periodic and sporadic tasks under EDF and Rate-Monotonic
+ *   scheduling. A utilization and response-time schedulability test runs
+ *   first; the report gives deadline misses and lateness percentiles.
+ *   Task files hold one "period,wcet[,deadline[,phase[,sporadic]]]" per line.
+ *
+ * Dispatch benchmark:
+ * - --bench-dispatch times the Priority scheduler with its bitmap pick
+ *   against the same schedule picked by a linear scan of the process table
+ *   (the way the old tick-by-tick SRTF found its next process).
+ *
+ * Multi-core (SMP) simulation:
+ * - --cpus N [--epoch E] [--threads T] runs SRTF and Round Robin on N
+ *   simulated CPUs, each with its own run queue. Time advances in epochs of
+ *   E units; within an epoch every CPU is simulated independently (in
+ *   parallel on T host threads), and between epochs new arrivals go to the
+ *   least loaded CPU and idle CPUs steal work from the busiest run queue.
+ *
+ * Compile with: gcc cpu_scheduling.c -o cpu_scheduling -lm -pthread
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <limits.h> // For INT_MAX in finding minimum remaining time
+#include <string.h>
+#include <pthread.h>
+#include <time.h>   // For clock_gettime() in the dispatch benchmark
+#include <unistd.h> // For sysconf() to size the thread pool
+#include "sched_engine.h" // Process table, scheduler engine and policies
 
-/* Process Control Block (PCB) Structure */
+/* Command line options for non-interactive runs */
 typedef struct {
-    int id;              // Process identifier
-    int arrival_time;    // Time process arrives in system
-    int burst_time;      // Total CPU time required
-    
-    /* Metrics for analysis */
-    int remaining_time;   // Time still needed to complete
-    int completion_time; // Time when process finishes
-    int turnaround_time; // Total time in system
-    int waiting_time;    // Time spent waiting
-} Process;
+    int quantum;      // Round Robin quantum for a single run
+    int sweep_min;    // First quantum of a sweep (0 = no sweep)
+    int sweep_max;    // Last quantum of a sweep
+    int sweep_step;   // Quantum increment between sweep configurations
+    int threads;      // Host worker threads for a sweep or SMP run
+    int cpus;         // Simulated CPUs (0 = single-CPU simulation)
+    int epoch;        // SMP load-balancing interval in time units
+    int bench_dispatch; // Time bitmap vs linear-scan priority dispatch
+    const SchedPolicy *policy; // Run only this policy (NULL = all of them)
+    int summary;      // Print percentile summaries instead of per-process rows
+} RunOptions;
+
+/* Run queue types supported by the SMP simulation */
+typedef enum { ALG_SRTF, ALG_RR } Algorithm;
+
+/* One (policy, quantum) configuration of a sweep and its results */
+typedef struct {
+    const SchedPolicy *policy;
+    int quantum;
+    double avg_waiting_time;
+    double avg_turnaround_time;
+} SweepJob;
+
+/* State shared by all sweep workers */
+typedef struct {
+    const Process *trace;  // Read-only input shared by every worker
+    int n;
+    SweepJob *jobs;
+    int n_jobs;
+    int next_job;          // Next unclaimed job, taken with an atomic add
+} SweepContext;
+
+/* One simulated CPU of an SMP run */
+typedef struct {
+    ReadyHeap heap;         // SRTF run queue
+    ReadyQueue queue;       // Round Robin run queue
+    int running;            // Process on this CPU, -1 if idle
+    int slice_left;         // Round Robin: time left in the running quantum
+    int *incoming;          // Arrivals placed here for the current epoch, in arrival order
+    int n_incoming;
+    int incoming_capacity;
+    long long busy_time;    // Time spent executing processes
+    int completed;          // Processes that finished on this CPU
+    int migrations_in;      // Processes this CPU stole
+    int migrations_out;     // Processes stolen from this CPU
+} Cpu;
+
+/* State shared by the host threads of an SMP run */
+typedef struct {
+    Process *proc;
+    int n;
+    Algorithm algorithm;
+    int quantum;
+    Cpu *cpus;
+    int n_cpus;
+    int n_threads;
+    int *order;             // Processes sorted by arrival time
+    int next_arrival;       // Position in 'order' of the next unplaced arrival
+    long long epoch_start;  // Current epoch is [epoch_start, epoch_start + epoch_len)
+    long long epoch_len;
+    int done;               // Set by the coordinator once every process completed
+    pthread_barrier_t barrier;
+} SmpContext;
+
+/* Per-thread argument for SMP workers */
+typedef struct {
+    SmpContext *ctx;
+    int id;
+} SmpThread;
+
+/* Real-time task: releases a job every 'period' (periodic) or at least 'period' apart (sporadic) */
+typedef struct {
+    int id;
+    int period;       // T: period, or minimum inter-arrival time of a sporadic task
+    int wcet;         // C: execution time of every job
+    int deadline;     // D: deadline relative to each release
+    int phase;        // Release time of the first job
+    int sporadic;     // 1 if releases are sporadic rather than strictly periodic
+    long long next_release; // Simulation state: release time of the next job
+    int jobs;         // Simulation results per task
+    int misses;
+    long long max_lateness;
+} RtTask;
+
+/* One job (instance) of a real-time task */
+typedef struct {
+    int task;
+    long long release;
+    long long abs_deadline;
+    int remaining;
+} RtJob;
+
+typedef enum { RT_EDF, RT_RM } RtPolicy;
+
+/* Binary heap of job indices; the order depends on the policy (see rt_job_before) */
+typedef struct {
+    int *idx;
+    int size;
+    int capacity;
+    RtPolicy policy;
+    const RtJob *jobs;
+    const RtTask *tasks;
+} JobHeap;
 
 // Function Prototypes
-void run_srtf(Process proc[], int n);
-void run_round_robin(Process proc[], int n, int quantum);
-void print_results(Process proc[], int n, const char* algorithm_name);
+void run_dispatch_benchmark(const Process trace[], int n, int quantum);
+int run_realtime(int argc, char* argv[]);
+void run_sweep(const Process trace[], int n, const RunOptions* opts);
+void run_smp(Process proc[], int n, Algorithm algorithm, const RunOptions* opts);
+Process* read_processes_interactive(int* n, int* quantum);
+Process* read_processes_from_args(int argc, char* argv[], int* n, RunOptions* opts);
 
-int main() {
-    int n, quantum;
+int main(int argc, char* argv[]) {
+    int n;
+    RunOptions opts = { 4, 0, 0, 1, 0, 0, 16, 0, NULL, 0 };
 
-    printf("Enter the number of processes: ");
-    scanf("%d", &n);
-    if (n <= 0) {
-        printf("Must have at least one process.\n");
+    // Real-time task sets have their own input and report
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--rt") == 0 || strcmp(argv[i], "--rt-generate") == 0) {
+            return run_realtime(argc, argv);
+        }
+    }
+
+    // Read the workload either interactively or from a trace/generator
+    Process* processes_srtf = (argc > 1) ? read_processes_from_args(argc, argv, &n, &opts)
+                                         : read_processes_interactive(&n, &opts.quantum);
+    if (processes_srtf == NULL) {
         return 1;
     }
 
-    // Allocate two separate arrays for the processes
-    Process* processes_srtf = (Process*)malloc(n * sizeof(Process));
+    if (opts.sweep_min > 0) {
+        run_sweep(processes_srtf, n, &opts);
+        free(processes_srtf);
+        return 0;
+    }
+    if (opts.bench_dispatch) {
+        run_dispatch_benchmark(processes_srtf, n, opts.quantum);
+        free(processes_srtf);
+        return 0;
+    }
+
+    // Copy the initial data to separate arrays for Round Robin and CFS
     Process* processes_rr = (Process*)malloc(n * sizeof(Process));
+    memcpy(processes_rr, processes_srtf, n * sizeof(Process));
+    Process* processes_cfs = (Process*)malloc(n * sizeof(Process));
+    memcpy(processes_cfs, processes_srtf, n * sizeof(Process));
+    Process* processes_prio = (Process*)malloc(n * sizeof(Process));
+    memcpy(processes_prio, processes_srtf, n * sizeof(Process));
+
+    // --- Run Simulations ---
+    if (opts.cpus > 0) {
+        run_smp(processes_srtf, n, ALG_SRTF, &opts);
+        run_smp(processes_rr, n, ALG_RR, &opts);
+    } else if (opts.policy != NULL) {
+        sched_run(opts.policy, processes_srtf, n, opts.quantum, opts.summary);
+    } else {
+        sched_run(&srtf_policy, processes_srtf, n, opts.quantum, opts.summary);
+        sched_run(&round_robin_policy, processes_rr, n, opts.quantum, opts.summary);
+        sched_run(&cfs_policy, processes_cfs, n, opts.quantum, opts.summary);
+        sched_run(&priority_policy, processes_prio, n, opts.quantum, opts.summary);
+    }
+
+    // Free the allocated memory
+    free(processes_srtf);
+    free(processes_rr);
+    free(processes_cfs);
+    free(processes_prio);
+    return 0;
+}
+
+/**
+ * @brief Prompts for the process table and quantum on stdin.
+ * @return Newly allocated process array, or NULL on invalid input.
+ */
+Process* read_processes_interactive(int* n, int* quantum) {
+    printf("Enter the number of processes: ");
+    scanf("%d", n);
+    if (*n <= 0) {
+        printf("Must have at least one process.\n");
+        return NULL;
+    }
+
+    Process* proc = (Process*)malloc(*n * sizeof(Process));
 
     printf("\nEnter process details (Arrival Time Burst Time):\n");
-    for (int i = 0; i < n; i++) {
+    for (int i = 0; i < *n; i++) {
         printf("Process P%d: ", i);
-        processes_srtf[i].id = i;
-        scanf("%d %d", &processes_srtf[i].arrival_time, &processes_srtf[i].burst_time);
-        processes_srtf[i].remaining_time = processes_srtf[i].burst_time;
-        
-        // Copy the initial data to the second array for Round Robin
-        processes_rr[i] = processes_srtf[i];
+        proc[i].id = i;
+        scanf("%d %d", &proc[i].arrival_time, &proc[i].burst_time);
+        proc[i].nice = 0;
+        proc[i].static_priority = proc[i].priority = 120;
+        proc[i].remaining_time = proc[i].burst_time;
     }
 
     printf("\nEnter the time quantum for Round Robin: ");
-    scanf("%d", &quantum);
-    if (quantum <= 0) {
+    scanf("%d", quantum);
+    if (*quantum <= 0) {
         printf("Time quantum must be positive.\n");
-        return 1;
+        free(proc);
+        return NULL;
     }
+    return proc;
+}
 
-    // --- Run Simulations ---
-    run_srtf(processes_srtf, n);
-    run_round_robin(processes_rr, n, quantum);
+/**
+ * @brief Builds the process table from --trace or --generate command line options.
+ * @return Newly allocated process array, or NULL on bad options or an unreadable trace.
+ */
+Process* read_processes_from_args(int argc, char* argv[], int* n, RunOptions* opts) {
+    const char* trace_path = NULL;
+    const char* save_path = NULL;
+    int generate_n = -1, min_burst = 1, sweep = 0;
+    double rate = 0.25, alpha = 1.5;
+    unsigned long long seed = 1;
+    WorkloadRecord* recs;
 
-    // Free the allocated memory
-    free(processes_srtf);
-    free(processes_rr);
-    return 0;
+    for (int i = 1; i < argc; i++) {
+        int has_value = (i + 1 < argc);
+        if (strcmp(argv[i], "--trace") == 0 && has_value) trace_path = argv[++i];
+        else if (strcmp(argv[i], "--generate") == 0 && has_value) generate_n = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--quantum") == 0 && has_value) opts->quantum = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--sweep") == 0 && i + 2 < argc) {
+            sweep = 1;
+            opts->sweep_min = atoi(argv[++i]);
+            opts->sweep_max = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--step") == 0 && has_value) opts->sweep_step = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && has_value) opts->threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--cpus") == 0 && has_value) opts->cpus = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--epoch") == 0 && has_value) opts->epoch = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bench-dispatch") == 0) opts->bench_dispatch = 1;
+        else if (strcmp(argv[i], "--summary") == 0) opts->summary = 1;
+        else if (strcmp(argv[i], "--policy") == 0 && has_value) {
+            opts->policy = sched_find_policy(argv[++i]);
+            if (opts->policy == NULL) {
+                fprintf(stderr, "Unknown policy: %s\n", argv[i]);
+                return NULL;
+            }
+        }
+        else if (strcmp(argv[i], "--rate") == 0 && has_value) rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--alpha") == 0 && has_value) alpha = atof(argv[++i]);
+        else if (strcmp(argv[i], "--min-burst") == 0 && has_value) min_burst = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && has_value) seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--save") == 0 && has_value) save_path = argv[++i];
+        else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+            return NULL;
+        }
+    }
+
+    if (opts->quantum <= 0) {
+        printf("Time quantum must be positive.\n");
+        return NULL;
+    }
+    if ((sweep && (opts->sweep_min < 1 || opts->sweep_max < opts->sweep_min)) || opts->sweep_step <= 0) {
+        printf("Sweep range must be 1 <= QMIN <= QMAX with a positive step.\n");
+        return NULL;
+    }
+    if (opts->cpus < 0 || opts->epoch <= 0) {
+        printf("CPU count and epoch length must be positive.\n");
+        return NULL;
+    }
+    if (trace_path != NULL) {
+        recs = load_workload(trace_path, n);
+    } else if (generate_n > 0 && rate > 0 && alpha > 0 && min_burst > 0) {
+        *n = generate_n;
+        recs = generate_workload(generate_n, rate, alpha, min_burst, seed);
+    } else {
+        fprintf(stderr, "Usage: %s [--trace FILE | --generate N [--rate R] [--alpha A] "
+                        "[--min-burst B] [--seed S] [--save FILE]] [--quantum Q] "
+                        "[--sweep QMIN QMAX [--step S] [--threads T]] "
+                        "[--cpus N [--epoch E] [--threads T]] [--bench-dispatch] [--policy NAME] [--summary]\n", argv[0]);
+        return NULL;
+    }
+    if (recs == NULL) return NULL;
+    if (*n <= 0) {
+        printf("Must have at least one process.\n");
+        free(recs);
+        return NULL;
+    }
+    if (save_path != NULL && write_workload_binary(save_path, recs, *n) != 0) {
+        free(recs);
+        return NULL;
+    }
+
+    Process* proc = processes_from_records(recs, *n);
+    free(recs);
+    return proc;
 }
 
+
 /**
- * @brief Simulates Preemptive Shortest Job First (SRTF)
+ * @brief Wall-clock seconds from a monotonic clock.
  */
-void run_srtf(Process proc[], int n) {
-    int current_time = 0;
-    int completed = 0;
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
 
-    while (completed != n) {
-        int shortest_idx = -1;
-        int min_remaining = INT_MAX;
+/**
+ * @brief Runs the Priority scheduler with bitmap and with linear-scan dispatch on
+ *        the same trace, checks the schedules agree and reports the cost of each.
+ */
+void run_dispatch_benchmark(const Process trace[], int n, int quantum) {
+    Process* bitmap_run = (Process*)malloc(n * sizeof(Process));
+    Process* linear_run = (Process*)malloc(n * sizeof(Process));
+    memcpy(bitmap_run, trace, n * sizeof(Process));
+    memcpy(linear_run, trace, n * sizeof(Process));
+
+    double start = now_seconds();
+    long long dispatches = sched_simulate(&priority_policy, bitmap_run, n, quantum, NULL);
+    double bitmap_time = now_seconds() - start;
+
+    start = now_seconds();
+    sched_simulate(&priority_linear_policy, linear_run, n, quantum, NULL);
+    double linear_time = now_seconds() - start;
+
+    int same = 1;
+    for (int i = 0; i < n && same; i++) {
+        same = (bitmap_run[i].completion_time == linear_run[i].completion_time);
+    }
 
-        // Find the process with the shortest remaining time among all
-        // processes that have arrived and are not yet complete.
-        for (int i = 0; i < n; i++) {
-            if (proc[i].arrival_time <= current_time && proc[i].remaining_time > 0) {
-                if (proc[i].remaining_time < min_remaining) {
-                    min_remaining = proc[i].remaining_time;
-                    shortest_idx = i;
+    printf("\n---=== [ Dispatch Benchmark: %d processes, %lld dispatches ] ===---\n", n, dispatches);
+    printf("Dispatcher\tTotal (s)\tRun time per dispatch (ns)\n");
+    printf("--------------------------------------------------\n");
+    printf("Bitmap O(1)\t%.4f\t\t%.1f\n", bitmap_time, 1e9 * bitmap_time / dispatches);
+    printf("Linear scan\t%.4f\t\t%.1f\n", linear_time, 1e9 * linear_time / dispatches);
+    printf("--------------------------------------------------\n");
+    printf("Speedup:                 %.1fx\n", linear_time / bitmap_time);
+    printf("Schedules identical:     %s\n\n", same ? "yes" : "NO");
+
+    free(bitmap_run);
+    free(linear_run);
+}
+
+/**
+ * @brief Dispatch order. EDF: earlier absolute deadline first. RM: shorter
+ *        period (higher rate) first. Ties go to the earlier release, then
+ *        the lower task id, so both policies are deterministic.
+ */
+int rt_job_before(const JobHeap* h, int a, int b) {
+    const RtJob* x = &h->jobs[a];
+    const RtJob* y = &h->jobs[b];
+    if (h->policy == RT_EDF) {
+        if (x->abs_deadline != y->abs_deadline) return x->abs_deadline < y->abs_deadline;
+    } else {
+        int tx = h->tasks[x->task].period, ty = h->tasks[y->task].period;
+        if (tx != ty) return tx < ty;
+    }
+    if (x->release != y->release) return x->release < y->release;
+    return x->task < y->task;
+}
+
+void job_heap_push(JobHeap* h, int j) {
+    if (h->size == h->capacity) {
+        h->capacity *= 2;
+        h->idx = (int*)realloc(h->idx, h->capacity * sizeof(int));
+    }
+    int pos = h->size++;
+    while (pos > 0 && rt_job_before(h, j, h->idx[(pos - 1) / 2])) {
+        h->idx[pos] = h->idx[(pos - 1) / 2];
+        pos = (pos - 1) / 2;
+    }
+    h->idx[pos] = j;
+}
+
+int job_heap_pop(JobHeap* h) {
+    int top = h->idx[0];
+    int last = h->idx[--h->size];
+    int pos = 0, child;
+    while ((child = 2 * pos + 1) < h->size) {
+        if (child + 1 < h->size && rt_job_before(h, h->idx[child + 1], h->idx[child])) child++;
+        if (!rt_job_before(h, h->idx[child], last)) break;
+        h->idx[pos] = h->idx[child];
+        pos = child;
+    }
+    if (h->size > 0) h->idx[pos] = last;
+    return top;
+}
+
+/**
+ * @brief Loads a task set, one "period,wcet[,deadline[,phase[,sporadic]]]" per line.
+ *        The deadline defaults to the period; blank lines and lines starting
+ *        with '#' are skipped.
+ * @return Newly allocated task array, or NULL on a bad line.
+ */
+RtTask* load_task_set(const char* path, int* n_tasks) {
+    FILE* fp = fopen(path, "r");
+    char line[256];
+    int capacity = 16, count = 0, line_no = 0;
+
+    if (fp == NULL) {
+        perror(path);
+        return NULL;
+    }
+    RtTask* tasks = (RtTask*)malloc(capacity * sizeof(RtTask));
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        RtTask t = { 0 };
+        const char* p = line;
+        line_no++;
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+        if (*p == '\0' || *p == '#') continue;
+
+        int fields = sscanf(line, "%d , %d , %d , %d , %d", &t.period, &t.wcet, &t.deadline, &t.phase, &t.sporadic);
+        if (fields < 3) t.deadline = t.period;
+        if (fields < 2 || t.period <= 0 || t.wcet <= 0 || t.deadline <= 0 || t.phase < 0) {
+            fprintf(stderr, "Bad task on line %d of %s\n", line_no, path);
+            fclose(fp);
+            free(tasks);
+            return NULL;
+        }
+        if (count == capacity) {
+            capacity *= 2;
+            tasks = (RtTask*)realloc(tasks, capacity * sizeof(RtTask));
+        }
+        t.id = count;
+        tasks[count++] = t;
+    }
+    fclose(fp);
+    *n_tasks = count;
+    return tasks;
+}
+
+/**
+ * @brief Random implicit-deadline task set with total utilization 'util' (UUniFast),
+ *        periods log-uniform in [10, 1000].
+ */
+RtTask* generate_task_set(int n_tasks, double util, uint64_t seed) {
+    RtTask* tasks = (RtTask*)calloc(n_tasks, sizeof(RtTask));
+    uint64_t state = seed;
+    double remaining_util = util;
+
+    for (int i = 0; i < n_tasks; i++) {
+        double u = remaining_util;
+        if (i < n_tasks - 1) {
+            double next = remaining_util * pow(workload_uniform(&state), 1.0 / (n_tasks - 1 - i));
+            u = remaining_util - next;
+            remaining_util = next;
+        }
+        tasks[i].id = i;
+        tasks[i].period = (int)(10.0 * pow(100.0, workload_uniform(&state)));
+        tasks[i].wcet = (int)(u * tasks[i].period + 0.5);
+        if (tasks[i].wcet < 1) tasks[i].wcet = 1;
+        tasks[i].deadline = tasks[i].period;
+    }
+    return tasks;
+}
+
+/**
+ * @brief Schedulability analysis printed before simulating.
+ *        EDF: U <= 1 is exact for D >= T; otherwise density <= 1 is sufficient.
+ *        RM:  the Liu & Layland bound is sufficient for D >= T; response-time analysis
+ *             is exact: every job q in the level-i busy period completes at
+ *             w = (q+1) C + sum ceil(w/Tj) Cj over higher-rate tasks, and
+ *             R = max(w - q T). With D <= T only the first job matters; with
+ *             D > T later jobs can also be delayed by the task's own backlog.
+ */
+void rt_schedulability(const RtTask tasks[], int n_tasks) {
+    double util = 0, density = 0;
+    int implicit = 1, rta_ok = 1;
+
+    for (int i = 0; i < n_tasks; i++) {
+        int d = tasks[i].deadline < tasks[i].period ? tasks[i].deadline : tasks[i].period;
+        util += (double)tasks[i].wcet / tasks[i].period;
+        density += (double)tasks[i].wcet / d;
+        if (tasks[i].deadline < tasks[i].period) implicit = 0;
+    }
+    double ll_bound = n_tasks * (pow(2.0, 1.0 / n_tasks) - 1);
+
+    printf("\n---=== [ Schedulability Test: %d tasks ] ===---\n", n_tasks);
+    printf("Utilization U:           %.4f\n", util);
+    if (implicit) {
+        printf("EDF (U <= 1, exact):     %s\n", util <= 1.0 ? "schedulable" : "NOT schedulable");
+    } else {
+        printf("EDF (density %.4f <= 1): %s\n", density,
+               density <= 1.0 ? "schedulable" : util <= 1.0 ? "inconclusive" : "NOT schedulable");
+    }
+    if (implicit) {
+        printf("RM Liu-Layland bound:    %.4f (%s)\n", ll_bound, util <= ll_bound ? "schedulable" : "inconclusive");
+    } else {
+        printf("RM Liu-Layland bound:    n/a (constrained deadlines)\n");
+    }
+
+    printf("Task\tT\tC\tD\tR (RM)\n");
+    printf("--------------------------------------------------\n");
+    for (int i = 0; i < n_tasks; i++) {
+        // One fixed-point iteration per job of the busy period; stops as soon as R passes the deadline.
+        long long r = 0;
+        for (long long q = 0; r <= tasks[i].deadline; q++) {
+            long long w = (q + 1) * tasks[i].wcet, prev = -1;
+            while (w != prev && w - q * tasks[i].period <= tasks[i].deadline) {
+                prev = w;
+                w = (q + 1) * tasks[i].wcet;
+                for (int j = 0; j < n_tasks; j++) {
+                    int higher = tasks[j].period < tasks[i].period || (tasks[j].period == tasks[i].period && j < i);
+                    if (higher) w += ((prev + tasks[j].period - 1) / tasks[j].period) * tasks[j].wcet;
                 }
             }
+            if (w - q * tasks[i].period > r) r = w - q * tasks[i].period;
+            if (w <= (q + 1) * tasks[i].period) break; // Busy period ends before the next release
         }
+        if (r > tasks[i].deadline) rta_ok = 0;
+        printf("T%d\t%d\t%d\t%d\t", tasks[i].id, tasks[i].period, tasks[i].wcet, tasks[i].deadline);
+        if (r > tasks[i].deadline) printf("> D\n");
+        else printf("%lld\n", r);
+    }
+    printf("--------------------------------------------------\n");
+    printf("RM response-time test:   %s\n", (rta_ok && util <= 1.0) ? "schedulable" : "NOT schedulable");
+}
 
-        if (shortest_idx == -1) {
-            // No process is ready, CPU is idle.
-            current_time++;
-        } else {
-            // Execute the shortest process for one time unit
-            proc[shortest_idx].remaining_time--;
-            current_time++;
-
-            // Check if the process has completed
-            if (proc[shortest_idx].remaining_time == 0) {
-                proc[shortest_idx].completion_time = current_time;
-                proc[shortest_idx].turnaround_time = proc[shortest_idx].completion_time - proc[shortest_idx].arrival_time;
-                proc[shortest_idx].waiting_time = proc[shortest_idx].turnaround_time - proc[shortest_idx].burst_time;
-                completed++;
+// qsort comparison for lateness values
+int compare_long_long(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Simulates n_jobs job releases of the task set under EDF or RM and prints
+ *        deadline misses and lateness percentiles.
+ *
+ * Event-driven: the next event is the earliest pending release or the running
+ * job's completion. Releases come from a second heap (keyed on release time),
+ * and ready jobs wait in a JobHeap ordered by the policy, so each event is
+ * O(log n). Jobs that miss their deadline still run to completion (soft
+ * real-time), so lateness is measured instead of jobs being dropped.
+ */
+void simulate_realtime(RtTask tasks[], int n_tasks, int n_jobs, RtPolicy policy, uint64_t seed) {
+    RtJob* jobs = (RtJob*)malloc(n_jobs * sizeof(RtJob));
+    long long* lateness = (long long*)malloc(n_jobs * sizeof(long long));
+    int* release_heap = (int*)malloc(n_tasks * sizeof(int)); // Tasks keyed on next_release
+    int n_release = 0, released = 0, finished = 0, misses = 0;
+    long long current_time = 0;
+    int running = -1;
+    uint64_t state = seed;
+    JobHeap ready = { (int*)malloc(64 * sizeof(int)), 0, 64, policy, jobs, tasks };
+
+    for (int i = 0; i < n_tasks; i++) {
+        tasks[i].next_release = tasks[i].phase;
+        tasks[i].jobs = tasks[i].misses = 0;
+        tasks[i].max_lateness = 0;
+        // Sift the task into the release heap.
+        int pos = n_release++;
+        while (pos > 0 && tasks[release_heap[(pos - 1) / 2]].next_release > tasks[i].next_release) {
+            release_heap[pos] = release_heap[(pos - 1) / 2];
+            pos = (pos - 1) / 2;
+        }
+        release_heap[pos] = i;
+    }
+
+    while (finished < n_jobs) {
+        // Release every job due by now.
+        while (released < n_jobs && tasks[release_heap[0]].next_release <= current_time) {
+            RtTask* task = &tasks[release_heap[0]];
+            RtJob* job = &jobs[released];
+            job->task = task->id;
+            job->release = task->next_release;
+            job->abs_deadline = task->next_release + task->deadline;
+            job->remaining = task->wcet;
+            job_heap_push(&ready, released++);
+
+            // Next release: exactly one period later, or later still for sporadic tasks.
+            task->next_release += task->period;
+            if (task->sporadic) task->next_release += (long long)(-log(workload_uniform(&state)) * task->period / 2);
+            int pos = 0, child, t = release_heap[0];
+            while ((child = 2 * pos + 1) < n_release) {
+                if (child + 1 < n_release && tasks[release_heap[child + 1]].next_release < tasks[release_heap[child]].next_release) child++;
+                if (tasks[release_heap[child]].next_release >= task->next_release) break;
+                release_heap[pos] = release_heap[child];
+                pos = child;
             }
+            release_heap[pos] = t;
         }
+
+        // A newly released job with higher priority preempts the running one.
+        if (running != -1 && ready.size > 0 && rt_job_before(&ready, ready.idx[0], running)) {
+            job_heap_push(&ready, running);
+            running = -1;
+        }
+        if (running == -1) {
+            if (ready.size == 0) {
+                current_time = tasks[release_heap[0]].next_release; // Idle until the next release
+                continue;
+            }
+            running = job_heap_pop(&ready);
+        }
+
+        long long finish = current_time + jobs[running].remaining;
+        long long next_release = (released < n_jobs) ? tasks[release_heap[0]].next_release : finish;
+        if (next_release < finish) {
+            jobs[running].remaining -= next_release - current_time;
+            current_time = next_release;
+            continue;
+        }
+
+        current_time = finish;
+        RtTask* task = &tasks[jobs[running].task];
+        long long late = finish - jobs[running].abs_deadline;
+        lateness[finished++] = late;
+        task->jobs++;
+        if (late > 0) {
+            task->misses++;
+            misses++;
+        }
+        if (task->jobs == 1 || late > task->max_lateness) task->max_lateness = late;
+        running = -1;
     }
-    
-    print_results(proc, n, "Shortest Job First (Preemptive - SRTF)");
+
+    qsort(lateness, n_jobs, sizeof(long long), compare_long_long);
+    printf("\n---=== [ %s: %d tasks, %d jobs ] ===---\n",
+           policy == RT_EDF ? "Earliest Deadline First (EDF)" : "Rate Monotonic (RM)", n_tasks, n_jobs);
+    printf("Deadline misses:         %d (%.3f%%)\n", misses, 100.0 * misses / n_jobs);
+    printf("Lateness p50/p90/p99:    %lld / %lld / %lld\n", lateness[(long long)n_jobs * 50 / 100],
+           lateness[(long long)n_jobs * 90 / 100], lateness[(long long)n_jobs * 99 / 100]);
+    printf("Lateness p99.9/max:      %lld / %lld\n", lateness[(long long)n_jobs * 999 / 1000], lateness[n_jobs - 1]);
+    printf("Task\tJobs\tMisses\tMax lateness\n");
+    printf("--------------------------------------------------\n");
+    for (int i = 0; i < n_tasks; i++) {
+        printf("T%d\t%d\t%d\t%lld\n", tasks[i].id, tasks[i].jobs, tasks[i].misses, tasks[i].max_lateness);
+    }
+    printf("--------------------------------------------------\n");
+
+    free(jobs);
+    free(lateness);
+    free(release_heap);
+    free(ready.idx);
 }
 
 /**
- * @brief Simulates Round Robin (RR)
+ * @brief Entry point of real-time mode: loads or generates a task set, runs the
+ *        schedulability test, then simulates EDF and RM on the same releases.
  */
-void run_round_robin(Process proc[], int n, int quantum) {
-    int current_time = 0;
-    int completed = 0;
+int run_realtime(int argc, char* argv[]) {
+    const char* path = NULL;
+    int n_tasks = 0, n_jobs = 100000;
+    double util = 0;
+    unsigned long long seed = 1;
+    RtTask* tasks;
 
-    // We can just loop through the array, simulating a circular queue
-    while (completed != n) {
-        int all_idle = 1; // Flag to check if CPU was idle
-        for (int i = 0; i < n; i++) {
-            if (proc[i].arrival_time <= current_time && proc[i].remaining_time > 0) {
-                all_idle = 0; // At least one process is ready
-                int exec_time = 0;
+    for (int i = 1; i < argc; i++) {
+        int has_value = (i + 1 < argc);
+        if (strcmp(argv[i], "--rt") == 0 && has_value) path = argv[++i];
+        else if (strcmp(argv[i], "--rt-generate") == 0 && i + 2 < argc) {
+            n_tasks = atoi(argv[++i]);
+            util = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--jobs") == 0 && has_value) n_jobs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && has_value) seed = strtoull(argv[++i], NULL, 10);
+        else {
+            fprintf(stderr, "Usage: %s --rt FILE | --rt-generate NTASKS UTIL [--jobs N] [--seed S]\n", argv[0]);
+            return 1;
+        }
+    }
 
-                // Determine execution time: quantum or remaining time
-                if (proc[i].remaining_time > quantum) {
-                    exec_time = quantum;
-                } else {
-                    exec_time = proc[i].remaining_time;
-                }
+    if (path != NULL) {
+        tasks = load_task_set(path, &n_tasks);
+        if (tasks == NULL) return 1;
+    } else if (n_tasks > 0 && util > 0) {
+        tasks = generate_task_set(n_tasks, util, seed);
+    } else {
+        printf("Need a task file or a positive task count and utilization.\n");
+        return 1;
+    }
+    if (n_tasks <= 0 || n_jobs <= 0) {
+        printf("Must have at least one task and one job.\n");
+        free(tasks);
+        return 1;
+    }
 
-                // Execute the process
-                current_time += exec_time;
-                proc[i].remaining_time -= exec_time;
+    rt_schedulability(tasks, n_tasks);
+    simulate_realtime(tasks, n_tasks, n_jobs, RT_EDF, seed);
+    simulate_realtime(tasks, n_tasks, n_jobs, RT_RM, seed);
+    free(tasks);
+    return 0;
+}
 
-                // Check if the process has completed
-                if (proc[i].remaining_time == 0) {
-                    proc[i].completion_time = current_time;
-                    proc[i].turnaround_time = proc[i].completion_time - proc[i].arrival_time;
-                    proc[i].waiting_time = proc[i].turnaround_time - proc[i].burst_time;
-                    completed++;
-                }
+/**
+ * @brief Sweep worker: claims jobs until none are left and simulates each on a private copy.
+ */
+void* sweep_worker(void* arg) {
+    SweepContext* ctx = (SweepContext*)arg;
+    Process* proc = (Process*)malloc(ctx->n * sizeof(Process));
+
+    while (1) {
+        int j = __atomic_fetch_add(&ctx->next_job, 1, __ATOMIC_RELAXED);
+        if (j >= ctx->n_jobs) break;
+        SweepJob* job = &ctx->jobs[j];
+
+        memcpy(proc, ctx->trace, ctx->n * sizeof(Process));
+        sched_simulate(job->policy, proc, ctx->n, job->quantum, NULL);
+        compute_averages(proc, ctx->n, &job->avg_waiting_time, &job->avg_turnaround_time);
+    }
+
+    free(proc);
+    return NULL;
+}
+
+/**
+ * @brief Runs SRTF, CFS, and Round Robin and Priority for every quantum in the
+ *        sweep range on a thread pool and prints one comparison table.
+ */
+void run_sweep(const Process trace[], int n, const RunOptions* opts) {
+    const int n_fixed = 2; // SRTF and CFS have no quantum to sweep
+    int n_rr = (opts->sweep_max - opts->sweep_min) / opts->sweep_step + 1;
+    int threads = opts->threads > 0 ? opts->threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    SweepContext ctx;
+
+    ctx.trace = trace;
+    ctx.n = n;
+    ctx.n_jobs = n_fixed + 2 * n_rr;
+    ctx.next_job = 0;
+    ctx.jobs = (SweepJob*)calloc(ctx.n_jobs, sizeof(SweepJob));
+    ctx.jobs[0].policy = &srtf_policy;
+    ctx.jobs[1].policy = &cfs_policy;
+    for (int i = 0; i < n_rr; i++) {
+        ctx.jobs[n_fixed + i].policy = &round_robin_policy;
+        ctx.jobs[n_fixed + i].quantum = opts->sweep_min + i * opts->sweep_step;
+        ctx.jobs[n_fixed + n_rr + i].policy = &priority_policy;
+        ctx.jobs[n_fixed + n_rr + i].quantum = opts->sweep_min + i * opts->sweep_step;
+    }
+
+    if (threads < 1) threads = 1;
+    if (threads > ctx.n_jobs) threads = ctx.n_jobs;
+    pthread_t* pool = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    for (int t = 0; t < threads; t++) {
+        pthread_create(&pool[t], NULL, sweep_worker, &ctx);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(pool[t], NULL);
+    }
+
+    // The best Round Robin quantum is the one with the lowest average waiting time
+    int best = n_fixed;
+    for (int j = n_fixed + 1; j < n_fixed + n_rr; j++) {
+        if (ctx.jobs[j].avg_waiting_time < ctx.jobs[best].avg_waiting_time) best = j;
+    }
+
+    printf("\n---=== [ Parameter Sweep: %d configurations, %d threads ] ===---\n", ctx.n_jobs, threads);
+    printf("Algorithm\tQuantum\tAvg WT\t\tAvg TAT\n");
+    printf("--------------------------------------------------\n");
+    for (int j = 0; j < ctx.n_jobs; j++) {
+        const SchedPolicy* policy = ctx.jobs[j].policy;
+        printf("%s\t%s", policy->name, strlen(policy->name) < 8 ? "\t" : "");
+        if (policy->uses_quantum) printf("%d", ctx.jobs[j].quantum);
+        else printf("-");
+        printf("\t%.2f\t\t%.2f%s\n", ctx.jobs[j].avg_waiting_time, ctx.jobs[j].avg_turnaround_time,
+               (j == best) ? "\t<- best RR quantum" : "");
+    }
+    printf("--------------------------------------------------\n");
+
+    free(pool);
+    free(ctx.jobs);
+}
+
+/**
+ * @brief Number of processes assigned to a CPU: running, queued and arriving this epoch.
+ */
+int cpu_load(const Cpu* cpu, Algorithm algorithm) {
+    int queued = (algorithm == ALG_SRTF) ? cpu->heap.size : cpu->queue.size;
+    return queued + cpu->n_incoming + (cpu->running != -1);
+}
+
+/**
+ * @brief Places every arrival of the current epoch on the least loaded CPU.
+ */
+void smp_place_arrivals(SmpContext* ctx) {
+    long long epoch_end = ctx->epoch_start + ctx->epoch_len;
+
+    while (ctx->next_arrival < ctx->n && ctx->proc[ctx->order[ctx->next_arrival]].arrival_time < epoch_end) {
+        int target = 0;
+        int min_load = cpu_load(&ctx->cpus[0], ctx->algorithm);
+        for (int c = 1; c < ctx->n_cpus && min_load > 0; c++) {
+            int load = cpu_load(&ctx->cpus[c], ctx->algorithm);
+            if (load < min_load) {
+                min_load = load;
+                target = c;
+            }
+        }
+
+        Cpu* cpu = &ctx->cpus[target];
+        if (cpu->n_incoming == cpu->incoming_capacity) {
+            cpu->incoming_capacity *= 2;
+            cpu->incoming = (int*)realloc(cpu->incoming, cpu->incoming_capacity * sizeof(int));
+        }
+        cpu->incoming[cpu->n_incoming++] = ctx->order[ctx->next_arrival++];
+    }
+}
+
+/**
+ * @brief Work stealing: every idle CPU pulls one waiting process from the busiest run queue.
+ */
+void smp_balance(SmpContext* ctx) {
+    for (int c = 0; c < ctx->n_cpus; c++) {
+        Cpu* idle = &ctx->cpus[c];
+        if (cpu_load(idle, ctx->algorithm) != 0) continue;
+
+        int busiest = -1, max_queued = 0;
+        for (int b = 0; b < ctx->n_cpus; b++) {
+            int queued = (ctx->algorithm == ALG_SRTF) ? ctx->cpus[b].heap.size : ctx->cpus[b].queue.size;
+            if (queued > max_queued) {
+                max_queued = queued;
+                busiest = b;
             }
         }
-        
-        // If no process was ready in that full cycle, increment time
-        if (all_idle) {
-            current_time++;
+        if (busiest == -1) return; // Nothing is waiting anywhere
+
+        // Take from the cheap end: a heap leaf, or the back of the RR queue.
+        Cpu* victim = &ctx->cpus[busiest];
+        int stolen;
+        if (ctx->algorithm == ALG_SRTF) {
+            stolen = victim->heap.idx[--victim->heap.size];
+            heap_push(&idle->heap, stolen);
+        } else {
+            stolen = queue_pop_back(&victim->queue);
+            queue_push(&idle->queue, stolen);
         }
+        victim->migrations_out++;
+        idle->migrations_in++;
     }
+}
 
-    print_results(proc, n, "Round Robin");
+/**
+ * @brief Marks process i complete at 'time' on the given CPU.
+ */
+void smp_complete(Process proc[], Cpu* cpu, int i, long long time) {
+    proc[i].remaining_time = 0;
+    proc[i].completion_time = time;
+    proc[i].turnaround_time = proc[i].completion_time - proc[i].arrival_time;
+    proc[i].waiting_time = proc[i].turnaround_time - proc[i].burst_time;
+    cpu->completed++;
 }
 
 /**
- * @brief Prints a formatted table of results
+ * @brief Simulates one CPU with SRTF for the current epoch, event by event.
  */
-void print_results(Process proc[], int n, const char* algorithm_name) {
-    float total_wt = 0, total_tat = 0;
+void smp_epoch_srtf(SmpContext* ctx, Cpu* cpu) {
+    Process* proc = ctx->proc;
+    long long t = ctx->epoch_start;
+    long long epoch_end = t + ctx->epoch_len;
+    int k = 0; // Next incoming arrival
 
-    printf("\n---=== [ %s ] ===---\n", algorithm_name);
-    printf("PID\tAT\tBT\tCT\tTAT\tWT\n");
-    printf("--------------------------------------------------\n");
+    while (1) {
+        while (k < cpu->n_incoming && proc[cpu->incoming[k]].arrival_time <= t) {
+            heap_push(&cpu->heap, cpu->incoming[k++]);
+        }
+        if (cpu->running != -1) {
+            heap_push(&cpu->heap, cpu->running);
+            cpu->running = -1;
+        }
+        if (t >= epoch_end) break;
+        if (cpu->heap.size == 0) {
+            if (k == cpu->n_incoming) break;
+            t = proc[cpu->incoming[k]].arrival_time; // Idle until the next arrival
+            continue;
+        }
 
+        int i = heap_pop(&cpu->heap);
+        note_first_run(&proc[i], t);
+        long long limit = epoch_end;
+        if (k < cpu->n_incoming && proc[cpu->incoming[k]].arrival_time < limit) {
+            limit = proc[cpu->incoming[k]].arrival_time;
+        }
+
+        if (t + proc[i].remaining_time <= limit) {
+            t += proc[i].remaining_time;
+            cpu->busy_time += proc[i].remaining_time;
+            smp_complete(proc, cpu, i, t);
+        } else {
+            proc[i].remaining_time -= limit - t;
+            cpu->busy_time += limit - t;
+            t = limit;
+            cpu->running = i;
+        }
+    }
+    cpu->n_incoming = 0;
+}
+
+/**
+ * @brief Simulates one CPU with Round Robin for the current epoch.
+ *        A quantum may span epochs; the running process keeps its CPU.
+ */
+void smp_epoch_round_robin(SmpContext* ctx, Cpu* cpu) {
+    Process* proc = ctx->proc;
+    long long t = ctx->epoch_start;
+    long long epoch_end = t + ctx->epoch_len;
+    int k = 0; // Next incoming arrival
+
+    while (1) {
+        while (k < cpu->n_incoming && proc[cpu->incoming[k]].arrival_time <= t) {
+            queue_push(&cpu->queue, cpu->incoming[k++]);
+        }
+        if (t >= epoch_end) break;
+        if (cpu->running != -1 && cpu->slice_left == 0) {
+            // Quantum expired on the previous epoch boundary; requeue after that instant's arrivals
+            queue_push(&cpu->queue, cpu->running);
+            cpu->running = -1;
+        }
+        if (cpu->running == -1) {
+            if (cpu->queue.size == 0) {
+                if (k == cpu->n_incoming) break;
+                t = proc[cpu->incoming[k]].arrival_time; // Idle until the next arrival
+                continue;
+            }
+            cpu->running = queue_pop(&cpu->queue);
+            cpu->slice_left = ctx->quantum;
+        }
+
+        int i = cpu->running;
+        long long run = proc[i].remaining_time;
+        if (run > cpu->slice_left) run = cpu->slice_left;
+        if (run > epoch_end - t) run = epoch_end - t;
+
+        note_first_run(&proc[i], t);
+        t += run;
+        proc[i].remaining_time -= run;
+        cpu->slice_left -= run;
+        cpu->busy_time += run;
+
+        // Arrivals during this run queue up ahead of a preempted process
+        while (k < cpu->n_incoming && proc[cpu->incoming[k]].arrival_time <= t) {
+            queue_push(&cpu->queue, cpu->incoming[k++]);
+        }
+        if (proc[i].remaining_time == 0) {
+            smp_complete(proc, cpu, i, t);
+            cpu->running = -1;
+        } else if (cpu->slice_left == 0 && t < epoch_end) {
+            queue_push(&cpu->queue, i);
+            cpu->running = -1;
+        }
+    }
+    cpu->n_incoming = 0;
+}
+
+/**
+ * @brief Coordinator step between epochs (runs on host thread 0 while the others wait).
+ */
+void smp_end_epoch(SmpContext* ctx) {
+    int completed = 0, all_idle = 1;
+
+    for (int c = 0; c < ctx->n_cpus; c++) {
+        completed += ctx->cpus[c].completed;
+        if (cpu_load(&ctx->cpus[c], ctx->algorithm) != 0) all_idle = 0;
+    }
+    if (completed == ctx->n) {
+        ctx->done = 1;
+        return;
+    }
+
+    ctx->epoch_start += ctx->epoch_len;
+    if (all_idle && ctx->proc[ctx->order[ctx->next_arrival]].arrival_time > ctx->epoch_start) {
+        // Every CPU is idle: skip the gap up to the next arrival
+        ctx->epoch_start = ctx->proc[ctx->order[ctx->next_arrival]].arrival_time;
+    }
+    smp_place_arrivals(ctx);
+    smp_balance(ctx);
+}
+
+/**
+ * @brief Host thread: simulates its share of the CPUs each epoch, synchronised by a barrier.
+ */
+void* smp_worker(void* arg) {
+    SmpThread* self = (SmpThread*)arg;
+    SmpContext* ctx = self->ctx;
+    int first = (int)((long long)self->id * ctx->n_cpus / ctx->n_threads);
+    int last = (int)((long long)(self->id + 1) * ctx->n_cpus / ctx->n_threads);
+
+    while (1) {
+        pthread_barrier_wait(&ctx->barrier); // Epoch set up by the coordinator
+        if (ctx->done) break;
+
+        for (int c = first; c < last; c++) {
+            if (ctx->algorithm == ALG_SRTF) smp_epoch_srtf(ctx, &ctx->cpus[c]);
+            else smp_epoch_round_robin(ctx, &ctx->cpus[c]);
+        }
+
+        pthread_barrier_wait(&ctx->barrier); // All CPUs finished the epoch
+        if (self->id == 0) smp_end_epoch(ctx);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Simulates SRTF or Round Robin on opts->cpus CPUs with per-CPU run
+ *        queues and work stealing, then prints the usual results table plus
+ *        per-CPU utilization and migration counts.
+ */
+void run_smp(Process proc[], int n, Algorithm algorithm, const RunOptions* opts) {
+    SmpContext ctx;
+    int host_cpus = opts->threads > 0 ? opts->threads : (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    ctx.proc = proc;
+    ctx.n = n;
+    ctx.algorithm = algorithm;
+    ctx.quantum = opts->quantum;
+    ctx.n_cpus = opts->cpus;
+    ctx.n_threads = (host_cpus < 1) ? 1 : (host_cpus > opts->cpus ? opts->cpus : host_cpus);
+    ctx.order = sort_by_arrival(proc, n);
+    ctx.next_arrival = 0;
+    ctx.epoch_start = proc[ctx.order[0]].arrival_time;
+    ctx.epoch_len = opts->epoch;
+    ctx.done = 0;
+
+    ctx.cpus = (Cpu*)calloc(ctx.n_cpus, sizeof(Cpu));
+    for (int c = 0; c < ctx.n_cpus; c++) {
+        Cpu* cpu = &ctx.cpus[c];
+        heap_init(&cpu->heap, proc, 16);
+        queue_init(&cpu->queue, 16);
+        cpu->running = -1;
+        cpu->incoming_capacity = 16;
+        cpu->incoming = (int*)malloc(cpu->incoming_capacity * sizeof(int));
+    }
+    smp_place_arrivals(&ctx);
+
+    pthread_barrier_init(&ctx.barrier, NULL, ctx.n_threads);
+    pthread_t* pool = (pthread_t*)malloc(ctx.n_threads * sizeof(pthread_t));
+    SmpThread* args = (SmpThread*)malloc(ctx.n_threads * sizeof(SmpThread));
+    for (int t = 0; t < ctx.n_threads; t++) {
+        args[t].ctx = &ctx;
+        args[t].id = t;
+        pthread_create(&pool[t], NULL, smp_worker, &args[t]);
+    }
+    for (int t = 0; t < ctx.n_threads; t++) {
+        pthread_join(pool[t], NULL);
+    }
+    pthread_barrier_destroy(&ctx.barrier);
+
+    char title[96];
+    snprintf(title, sizeof(title), "%s on %d CPUs (SMP, %d host threads)",
+             algorithm == ALG_SRTF ? "SRTF" : "Round Robin", ctx.n_cpus, ctx.n_threads);
+    if (opts->summary) {
+        SchedMetrics* metrics = (SchedMetrics*)calloc(1, sizeof(SchedMetrics));
+        for (int i = 0; i < n; i++) metrics_record(metrics, &proc[i]);
+        print_summary(metrics, title);
+        free(metrics);
+    } else {
+        print_results(proc, n, title);
+    }
+
+    long long makespan = 0;
+    int total_migrations = 0;
     for (int i = 0; i < n; i++) {
-        printf("P%d\t%d\t%d\t%d\t%d\t%d\n",
-               proc[i].id, proc[i].arrival_time, proc[i].burst_time,
-               proc[i].completion_time, proc[i].turnaround_time, proc[i].waiting_time);
-        
-        total_wt += proc[i].waiting_time;
-        total_tat += proc[i].turnaround_time;
-    }
-    
+        if (proc[i].completion_time > makespan) makespan = proc[i].completion_time;
+    }
+    printf("CPU\tBusy\tUtil%%\tDone\tMigIn\tMigOut\n");
     printf("--------------------------------------------------\n");
-    printf("Average Waiting Time:    %.2f\n", total_wt / n);
-    printf("Average Turnaround Time: %.2f\n\n", total_tat / n);
-}
\ No newline at end of file
+    for (int c = 0; c < ctx.n_cpus; c++) {
+        Cpu* cpu = &ctx.cpus[c];
+        printf("CPU%d\t%lld\t%.1f\t%d\t%d\t%d\n", c, cpu->busy_time,
+               makespan > 0 ? 100.0 * cpu->busy_time / makespan : 0.0,
+               cpu->completed, cpu->migrations_in, cpu->migrations_out);
+        total_migrations += cpu->migrations_in;
+        free(cpu->heap.idx);
+        free(cpu->queue.idx);
+        free(cpu->incoming);
+    }
+    printf("--------------------------------------------------\n");
+    printf("Total Migrations:        %d\n\n", total_migrations);
+
+    free(ctx.cpus);
+    free(ctx.order);
+    free(pool);
+    free(args);
+}
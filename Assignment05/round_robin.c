@@ -9,62 +9,52 @@
  * - Time Quantum: Each process gets a fixed amount of CPU time (quantum).
  * - Preemptive: If a process's burst time is longer than the quantum,
  *   it is preempted and moved to the back of the ready queue.
- * - Circular Queue: Processes are executed in a circular order.
+ * - Circular Queue: Processes are admitted in arrival order into a
+ *   ring-buffer ready queue; an idle CPU jumps straight to the next arrival.
+ * - The simulation itself is round_robin_policy on the shared engine in
+ *   sched_engine.h; this file only reads the input.
  *
  * Performance Metrics Calculated:
  * - Completion Time (CT): The time at which a process finishes execution.
  * - Turnaround Time (TAT): CT - Arrival Time.
  * - Waiting Time (WT): TAT - Burst Time.
+ *
+ * Usage: ./round_robin                  (interactive input)
+ *        ./round_robin FILE QUANTUM     (CSV or binary trace, see workload.h)
+ * Compile with: gcc round_robin.c -o round_robin -lm
  */
 
 # include<stdio.h>
+# include<stdlib.h>
+# include "sched_engine.h"
 
-int main(){
-    int at[10],bt[10],wt[10],tat[10],n,rem[10],qunatum,ct[10];
-    int count=0,exec,time=0;
-    float a_tat=0,a_wt=0;
-    
-    printf("Enter no. of processes:");
-    scanf("%d",&n);
-    for(int i=0;i<n;i++){
-        printf("\nP%d arrival time",i+1);
-        scanf("%d",&at[i]);
-        printf("\nP%d burst time",i+1);
-        scanf("%d",&bt[i]);
-        rem[i]=bt[i];
-    }
-     printf("\nEnter Time Qunatum");
-    scanf("%d",&qunatum);
-    printf("\nProcess\tAT\tBT\tTAT\tWT");
-    while(count<n){
-        exec=0;
+int main(int argc,char*argv[]){
+    int n,qunatum;
+    Process *proc;
+
+    if(argc>2){
+        proc=load_processes(argv[1],&n);
+        if(proc==NULL) return 1;
+        qunatum=atoi(argv[2]);
+    }else{
+        printf("Enter no. of processes:");
+        scanf("%d",&n);
+        if(n<=0) return 0;
+        WorkloadRecord *recs=calloc(n,sizeof(WorkloadRecord));
         for(int i=0;i<n;i++){
-            if(at[i]<=time && rem[i]>0){
-                exec=1;
-                if(rem[i]>qunatum){
-                    time+=qunatum;
-                    rem[i]-=qunatum;
-                }else{
-                    time+=rem[i];
-                    rem[i]=0;
-                    count++;
-                    ct[i]=time;
-                    tat[i]=ct[i]-at[i];
-                    wt[i]=tat[i]-bt[i];
-                    a_tat+=tat[i];
-                     a_wt+=wt[i];
-                }
-            }
+            printf("\nP%d arrival time",i+1);
+            scanf("%d",&recs[i].arrival_time);
+            printf("\nP%d burst time",i+1);
+            scanf("%d",&recs[i].burst_time);
         }
-        if(!exec){
-            time++;
-        }
-    }
-    for(int i=0;i<n;i++){
-         printf("\n%d\t%d\t%d\t%d\t%d",i+1,ct[i],bt[i],tat[i],wt[i]);
+        proc=processes_from_records(recs,n);
+        free(recs);
+        printf("\nEnter Time Qunatum");
+        scanf("%d",&qunatum);
     }
-    printf("\nAverage TAT:%f",a_tat/n);
-    printf("\nAverage WT:%f",a_wt/n);
+    if(n<=0||qunatum<=0){ free(proc); return 0; }
+    for(int i=0;i<n;i++) proc[i].id=i+1;
+    sched_run(&round_robin_policy,proc,n,qunatum,0);
+    free(proc);
     return 0;
-    
-}
\ No newline at end of file
+}
@@ -0,0 +1,1223 @@
+/*
+ * sched_engine.h
+ * ==============
+ * Shared scheduler engine for the CPU scheduling simulators.
+ *
+ * One event-driven engine (sched_simulate) drives every algorithm through a
+ * table of function pointers (SchedPolicy), so a policy only has to manage
+ * its own run queue:
+ * - srtf_policy:        min-heap keyed on remaining time
+ * - round_robin_policy: circular FIFO with a fixed quantum
+ * - cfs_policy:         red-black tree keyed on weighted vruntime
+ * - priority_policy:    140 FIFO queues plus a bitmap, with aging
+ *
+ * The header also holds the process table, the ready-queue data structures,
+ * the trace-to-process loader and the one results/metrics pass
+ * (print_results, or print_summary with streaming percentiles), so srtf.c,
+ * round_robin.c and cpu_scheduling.c share a single implementation. Like
+ * workload.h, every function is static inline so each program still
+ * compiles on its own.
+ */
+
+#ifndef SCHED_ENGINE_H
+#define SCHED_ENGINE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h> // For strcasecmp() in sched_find_policy()
+#include <limits.h>
+#include "workload.h"
+
+
+/* Process Control Block (PCB) Structure */
+typedef struct {
+    int id;              // Process identifier
+    int arrival_time;    // Time process arrives in system
+    int burst_time;      // Total CPU time required
+    int nice;            // Nice value -20..19, weights the CFS share
+    int static_priority; // 100 (highest) .. 139 (lowest), 120 + nice
+    int priority;        // Dynamic priority, raised by aging while waiting
+    
+    /* Metrics for analysis */
+    int remaining_time;   // Time still needed to complete
+    long long completion_time; // Time when process finishes
+    long long turnaround_time; // Total time in system
+    long long waiting_time;    // Time spent waiting
+    long long response_time;   // Time from arrival until first on the CPU
+} Process;
+
+/* Min-heap of ready process indices, ordered by (remaining_time, id) */
+typedef struct {
+    int *idx;        // Heap array of indices into proc[]
+    int size;        // Number of processes currently in the heap
+    int capacity;    // Allocated slots (grows when full)
+    Process *proc;   // Process table the indices refer to
+} ReadyHeap;
+
+/* Circular FIFO of ready process indices, used by Round Robin */
+typedef struct {
+    int *idx;        // Ring buffer of indices into proc[]
+    int head;        // Position of the front element
+    int size;        // Number of queued processes
+    int capacity;    // Allocated slots (grows when full)
+} ReadyQueue;
+
+/*
+ * Red-black tree of runnable processes ordered by (vruntime, index), used by CFS.
+ * Nodes are process indices; index 'nil' (== n) is the shared black sentinel.
+ */
+typedef struct {
+    int *left, *right, *parent;
+    char *red;             // 1 = red, 0 = black
+    long long *vruntime;   // Sort key of every node
+    int root;
+    int leftmost;          // Cached minimum, 'nil' when empty
+    int nil;
+} RbTree;
+
+/* Sort key used to order processes by arrival time */
+typedef struct {
+    int arrival_time;
+    int index;
+} ArrivalKey;
+
+// Comparison function for qsort: earlier arrival first, ties by index.
+static inline int compare_arrival(const void* a, const void* b) {
+    const ArrivalKey* x = (const ArrivalKey*)a;
+    const ArrivalKey* y = (const ArrivalKey*)b;
+    if (x->arrival_time != y->arrival_time) {
+        return (x->arrival_time < y->arrival_time) ? -1 : 1;
+    }
+    return (x->index < y->index) ? -1 : (x->index > y->index);
+}
+
+/**
+ * @brief Returns a newly allocated array of process indices sorted by arrival time.
+ */
+static inline int* sort_by_arrival(Process proc[], int n) {
+    ArrivalKey* keys = (ArrivalKey*)malloc(n * sizeof(ArrivalKey));
+    int* order = (int*)malloc(n * sizeof(int));
+
+    for (int i = 0; i < n; i++) {
+        keys[i].arrival_time = proc[i].arrival_time;
+        keys[i].index = i;
+    }
+    qsort(keys, n, sizeof(ArrivalKey), compare_arrival);
+    for (int i = 0; i < n; i++) {
+        order[i] = keys[i].index;
+    }
+
+    free(keys);
+    return order;
+}
+
+/**
+ * @brief Heap ordering: shorter remaining time first, ties go to the lower index
+ *        (the same choice the old tick-by-tick scan made).
+ */
+static inline int heap_less(const ReadyHeap* heap, int a, int b) {
+    const Process* pa = &heap->proc[a];
+    const Process* pb = &heap->proc[b];
+    if (pa->remaining_time != pb->remaining_time) {
+        return pa->remaining_time < pb->remaining_time;
+    }
+    return a < b;
+}
+
+/**
+ * @brief Allocates an empty ready heap over the process table 'proc'.
+ */
+static inline void heap_init(ReadyHeap* heap, Process proc[], int capacity) {
+    if (capacity < 1) capacity = 1;
+    heap->idx = (int*)malloc(capacity * sizeof(int));
+    heap->size = 0;
+    heap->capacity = capacity;
+    heap->proc = proc;
+}
+
+/**
+ * @brief Inserts process index i into the ready heap (sift up), doubling the array if full.
+ */
+static inline void heap_push(ReadyHeap* heap, int i) {
+    if (heap->size == heap->capacity) {
+        heap->capacity *= 2;
+        heap->idx = (int*)realloc(heap->idx, heap->capacity * sizeof(int));
+    }
+    int pos = heap->size++;
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!heap_less(heap, i, heap->idx[parent])) break;
+        heap->idx[pos] = heap->idx[parent];
+        pos = parent;
+    }
+    heap->idx[pos] = i;
+}
+
+/**
+ * @brief Removes and returns the process with the shortest remaining time (sift down).
+ */
+static inline int heap_pop(ReadyHeap* heap) {
+    int top = heap->idx[0];
+    int last = heap->idx[--heap->size];
+    int pos = 0;
+
+    while (1) {
+        int child = 2 * pos + 1;
+        if (child >= heap->size) break;
+        if (child + 1 < heap->size && heap_less(heap, heap->idx[child + 1], heap->idx[child])) {
+            child++;
+        }
+        if (!heap_less(heap, heap->idx[child], last)) break;
+        heap->idx[pos] = heap->idx[child];
+        pos = child;
+    }
+    if (heap->size > 0) heap->idx[pos] = last;
+    return top;
+}
+
+/**
+ * @brief Allocates an empty ready queue with room for 'capacity' processes.
+ */
+static inline void queue_init(ReadyQueue* q, int capacity) {
+    if (capacity < 1) capacity = 1;
+    q->idx = (int*)malloc(capacity * sizeof(int));
+    q->head = 0;
+    q->size = 0;
+    q->capacity = capacity;
+}
+
+/**
+ * @brief Appends process index i at the back of the queue, doubling the ring if full.
+ */
+static inline void queue_push(ReadyQueue* q, int i) {
+    if (q->size == q->capacity) {
+        int* grown = (int*)malloc(2 * q->capacity * sizeof(int));
+        for (int k = 0; k < q->size; k++) {
+            grown[k] = q->idx[(q->head + k) % q->capacity];
+        }
+        free(q->idx);
+        q->idx = grown;
+        q->head = 0;
+        q->capacity *= 2;
+    }
+    q->idx[(q->head + q->size) % q->capacity] = i;
+    q->size++;
+}
+
+/**
+ * @brief Removes and returns the process at the front of the queue.
+ */
+static inline int queue_pop(ReadyQueue* q) {
+    int front = q->idx[q->head];
+    q->head = (q->head + 1) % q->capacity;
+    q->size--;
+    return front;
+}
+
+/**
+ * @brief Removes and returns the process at the back of the queue (used for work stealing).
+ */
+static inline int queue_pop_back(ReadyQueue* q) {
+    q->size--;
+    return q->idx[(q->head + q->size) % q->capacity];
+}
+
+/*
+ * CFS tuning, in simulation time units. Linux uses 6ms / 0.75ms / 1ms; the
+ * same ratios are kept here with one time unit standing in for 0.25ms.
+ */
+#define CFS_TARGET_LATENCY 24    // Period in which every runnable process should run once
+#define CFS_MIN_GRANULARITY 3    // Shortest slice a process is given
+#define CFS_WAKEUP_GRANULARITY 4 // vruntime lead a new arrival needs to preempt
+#define CFS_NICE_0_LOAD 1024     // Weight of a nice 0 process
+#define CFS_VRUNTIME_SHIFT 10    // vruntime is kept in 1/1024 time units for precision
+
+/* Linux's sched_prio_to_weight[]: each nice step changes the CPU share by ~10% */
+static const int cfs_nice_to_weight[40] = {
+    /* -20 */ 88761, 71755, 56483, 46273, 36291,
+    /* -15 */ 29154, 23254, 18705, 14949, 11916,
+    /* -10 */  9548,  7620,  6100,  4904,  3906,
+    /*  -5 */  3121,  2501,  1991,  1586,  1277,
+    /*   0 */  1024,   820,   655,   526,   423,
+    /*   5 */   335,   272,   215,   172,   137,
+    /*  10 */   110,    87,    70,    56,    45,
+    /*  15 */    36,    29,    23,    18,    15,
+};
+
+/**
+ * @brief Tree order: smaller vruntime first, ties go to the lower index.
+ */
+static inline int rb_less(const RbTree* t, int a, int b) {
+    if (t->vruntime[a] != t->vruntime[b]) return t->vruntime[a] < t->vruntime[b];
+    return a < b;
+}
+
+/**
+ * @brief Allocates an empty tree for process indices 0..n-1.
+ */
+static inline void rb_init(RbTree* t, int n) {
+    t->left = (int*)malloc((n + 1) * sizeof(int));
+    t->right = (int*)malloc((n + 1) * sizeof(int));
+    t->parent = (int*)malloc((n + 1) * sizeof(int));
+    t->red = (char*)calloc(n + 1, sizeof(char));
+    t->vruntime = (long long*)calloc(n + 1, sizeof(long long));
+    t->nil = n;
+    t->root = n;
+    t->leftmost = n;
+    t->left[n] = t->right[n] = t->parent[n] = n;
+}
+
+static inline void rb_free(RbTree* t) {
+    free(t->left);
+    free(t->right);
+    free(t->parent);
+    free(t->red);
+    free(t->vruntime);
+}
+
+static inline void rb_rotate_left(RbTree* t, int x) {
+    int y = t->right[x];
+    t->right[x] = t->left[y];
+    if (t->left[y] != t->nil) t->parent[t->left[y]] = x;
+    t->parent[y] = t->parent[x];
+    if (t->parent[x] == t->nil) t->root = y;
+    else if (x == t->left[t->parent[x]]) t->left[t->parent[x]] = y;
+    else t->right[t->parent[x]] = y;
+    t->left[y] = x;
+    t->parent[x] = y;
+}
+
+static inline void rb_rotate_right(RbTree* t, int x) {
+    int y = t->left[x];
+    t->left[x] = t->right[y];
+    if (t->right[y] != t->nil) t->parent[t->right[y]] = x;
+    t->parent[y] = t->parent[x];
+    if (t->parent[x] == t->nil) t->root = y;
+    else if (x == t->right[t->parent[x]]) t->right[t->parent[x]] = y;
+    else t->left[t->parent[x]] = y;
+    t->right[y] = x;
+    t->parent[x] = y;
+}
+
+/**
+ * @brief Inserts node z keyed on t->vruntime[z] (CLRS insert + fixup).
+ */
+static inline void rb_insert(RbTree* t, int z) {
+    int y = t->nil, x = t->root;
+    while (x != t->nil) {
+        y = x;
+        x = rb_less(t, z, x) ? t->left[x] : t->right[x];
+    }
+    t->parent[z] = y;
+    if (y == t->nil) t->root = z;
+    else if (rb_less(t, z, y)) t->left[y] = z;
+    else t->right[y] = z;
+    t->left[z] = t->right[z] = t->nil;
+    t->red[z] = 1;
+    if (t->leftmost == t->nil || rb_less(t, z, t->leftmost)) t->leftmost = z;
+
+    while (t->red[t->parent[z]]) {
+        int p = t->parent[z], g = t->parent[p];
+        if (p == t->left[g]) {
+            int uncle = t->right[g];
+            if (t->red[uncle]) {
+                t->red[p] = t->red[uncle] = 0;
+                t->red[g] = 1;
+                z = g;
+            } else {
+                if (z == t->right[p]) {
+                    z = p;
+                    rb_rotate_left(t, z);
+                    p = t->parent[z];
+                }
+                t->red[p] = 0;
+                t->red[g] = 1;
+                rb_rotate_right(t, g);
+            }
+        } else {
+            int uncle = t->left[g];
+            if (t->red[uncle]) {
+                t->red[p] = t->red[uncle] = 0;
+                t->red[g] = 1;
+                z = g;
+            } else {
+                if (z == t->left[p]) {
+                    z = p;
+                    rb_rotate_right(t, z);
+                    p = t->parent[z];
+                }
+                t->red[p] = 0;
+                t->red[g] = 1;
+                rb_rotate_left(t, g);
+            }
+        }
+    }
+    t->red[t->root] = 0;
+}
+
+/**
+ * @brief Replaces subtree u with subtree v.
+ */
+static inline void rb_transplant(RbTree* t, int u, int v) {
+    if (t->parent[u] == t->nil) t->root = v;
+    else if (u == t->left[t->parent[u]]) t->left[t->parent[u]] = v;
+    else t->right[t->parent[u]] = v;
+    t->parent[v] = t->parent[u];
+}
+
+static inline int rb_minimum(const RbTree* t, int x) {
+    while (t->left[x] != t->nil) x = t->left[x];
+    return x;
+}
+
+/**
+ * @brief Removes node z from the tree (CLRS delete + fixup).
+ */
+static inline void rb_erase(RbTree* t, int z) {
+    int y = z, x;
+    char y_was_red = t->red[y];
+
+    if (z == t->leftmost) {
+        // The new minimum is z's in-order successor: its right subtree's minimum or its parent
+        t->leftmost = (t->right[z] != t->nil) ? rb_minimum(t, t->right[z]) : t->parent[z];
+    }
+
+    if (t->left[z] == t->nil) {
+        x = t->right[z];
+        rb_transplant(t, z, x);
+    } else if (t->right[z] == t->nil) {
+        x = t->left[z];
+        rb_transplant(t, z, x);
+    } else {
+        y = rb_minimum(t, t->right[z]);
+        y_was_red = t->red[y];
+        x = t->right[y];
+        if (t->parent[y] == z) {
+            t->parent[x] = y;
+        } else {
+            rb_transplant(t, y, t->right[y]);
+            t->right[y] = t->right[z];
+            t->parent[t->right[y]] = y;
+        }
+        rb_transplant(t, z, y);
+        t->left[y] = t->left[z];
+        t->parent[t->left[y]] = y;
+        t->red[y] = t->red[z];
+    }
+
+    if (!y_was_red) {
+        while (x != t->root && !t->red[x]) {
+            int p = t->parent[x];
+            if (x == t->left[p]) {
+                int w = t->right[p];
+                if (t->red[w]) {
+                    t->red[w] = 0;
+                    t->red[p] = 1;
+                    rb_rotate_left(t, p);
+                    w = t->right[p];
+                }
+                if (!t->red[t->left[w]] && !t->red[t->right[w]]) {
+                    t->red[w] = 1;
+                    x = p;
+                } else {
+                    if (!t->red[t->right[w]]) {
+                        t->red[t->left[w]] = 0;
+                        t->red[w] = 1;
+                        rb_rotate_right(t, w);
+                        w = t->right[p];
+                    }
+                    t->red[w] = t->red[p];
+                    t->red[p] = 0;
+                    t->red[t->right[w]] = 0;
+                    rb_rotate_left(t, p);
+                    x = t->root;
+                }
+            } else {
+                int w = t->left[p];
+                if (t->red[w]) {
+                    t->red[w] = 0;
+                    t->red[p] = 1;
+                    rb_rotate_right(t, p);
+                    w = t->left[p];
+                }
+                if (!t->red[t->right[w]] && !t->red[t->left[w]]) {
+                    t->red[w] = 1;
+                    x = p;
+                } else {
+                    if (!t->red[t->left[w]]) {
+                        t->red[t->right[w]] = 0;
+                        t->red[w] = 1;
+                        rb_rotate_left(t, w);
+                        w = t->left[p];
+                    }
+                    t->red[w] = t->red[p];
+                    t->red[p] = 0;
+                    t->red[t->left[w]] = 0;
+                    rb_rotate_right(t, p);
+                    x = t->root;
+                }
+            }
+        }
+        t->red[x] = 0;
+    }
+    t->parent[t->nil] = t->nil; // Fixup may have written through the sentinel
+}
+
+/* Priority scheduler tuning */
+#define PRIO_LEVELS 140        // Priorities 0..139 as in Linux; user processes use 100..139
+#define PRIO_USER_MAX 100      // Aging never raises a process above nice -20
+#define PRIO_AGING_INTERVAL 50 // Waiting this long raises the dynamic priority one level
+#define PRIO_BITMAP_WORDS ((PRIO_LEVELS + 63) / 64)
+
+/* Per-priority FIFO run queues threaded through next/prev arrays, plus a bitmap */
+typedef struct {
+    int head[PRIO_LEVELS];
+    int tail[PRIO_LEVELS];
+    unsigned long long bitmap[PRIO_BITMAP_WORDS]; // Bit p set when queue p is non-empty
+    int *next, *prev;            // Links between queued process indices, -1 terminated
+    long long *ready_since;      // When each queued process last joined its queue
+    long long *seq;              // Enqueue sequence number (orders each FIFO)
+    long long *slice_left;       // Unused slice of a preempted process, 0 for a fresh one
+    long long next_seq;
+    int *queued;                 // 1 while a process sits in a queue
+} PriorityQueues;
+
+/**
+ * @brief Time slice scaled by static priority the way the O(1) scheduler did
+ *        (nice 0 gets 'quantum', nice -20 gets 8x, nice 19 gets 1/20).
+ */
+static inline int priority_timeslice(int static_priority, int quantum) {
+    int scale = (static_priority < 120) ? (140 - static_priority) * 20 : (140 - static_priority) * 5;
+    int slice = quantum * scale / 100;
+    return slice > 0 ? slice : 1;
+}
+
+/**
+ * @brief Appends process i to the tail of the queue for its current priority.
+ */
+static inline void prio_enqueue(PriorityQueues* pq, Process proc[], int i, long long now) {
+    int p = proc[i].priority;
+    pq->next[i] = -1;
+    pq->prev[i] = pq->tail[p];
+    if (pq->tail[p] != -1) pq->next[pq->tail[p]] = i;
+    else pq->head[p] = i;
+    pq->tail[p] = i;
+    pq->bitmap[p / 64] |= 1ULL << (p % 64);
+    pq->ready_since[i] = now;
+    pq->seq[i] = pq->next_seq++;
+    pq->queued[i] = 1;
+}
+
+/**
+ * @brief Unlinks process i from its queue in O(1).
+ */
+static inline void prio_dequeue(PriorityQueues* pq, Process proc[], int i) {
+    int p = proc[i].priority;
+    if (pq->prev[i] != -1) pq->next[pq->prev[i]] = pq->next[i];
+    else pq->head[p] = pq->next[i];
+    if (pq->next[i] != -1) pq->prev[pq->next[i]] = pq->prev[i];
+    else pq->tail[p] = pq->prev[i];
+    if (pq->head[p] == -1) pq->bitmap[p / 64] &= ~(1ULL << (p % 64));
+    pq->queued[i] = 0;
+}
+
+/**
+ * @brief Highest non-empty priority via find-first-set on the bitmap, -1 if all are empty.
+ */
+static inline int prio_highest(const PriorityQueues* pq) {
+    for (int w = 0; w < PRIO_BITMAP_WORDS; w++) {
+        if (pq->bitmap[w]) return w * 64 + __builtin_ctzll(pq->bitmap[w]);
+    }
+    return -1;
+}
+
+/**
+ * @brief Reference pick for the benchmark: scans the whole process table for the
+ *        queued process with the best (priority, enqueue order), as a linear
+ *        scheduler would. It always agrees with the head of prio_highest().
+ */
+static inline int prio_pick_linear(const PriorityQueues* pq, const Process proc[], int n) {
+    int best = -1;
+    for (int i = 0; i < n; i++) {
+        if (!pq->queued[i]) continue;
+        if (best == -1 || proc[i].priority < proc[best].priority ||
+            (proc[i].priority == proc[best].priority && pq->seq[i] < pq->seq[best])) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Aging: every process that has waited PRIO_AGING_INTERVAL in its queue
+ *        moves up one level. Each FIFO is in enqueue order, so only the heads
+ *        of non-empty queues need to be checked.
+ */
+static inline void prio_age(PriorityQueues* pq, Process proc[], long long now) {
+    for (int p = PRIO_USER_MAX + 1; p < PRIO_LEVELS; p++) {
+        if (!(pq->bitmap[p / 64] & (1ULL << (p % 64)))) continue;
+        while (pq->head[p] != -1 && now - pq->ready_since[pq->head[p]] >= PRIO_AGING_INTERVAL) {
+            int i = pq->head[p];
+            prio_dequeue(pq, proc, i);
+            proc[i].priority--;
+            prio_enqueue(pq, proc, i, now);
+        }
+    }
+}
+
+/**
+ * @brief Earliest time at which prio_age() would promote a queued process, -1 if never.
+ */
+static inline long long prio_next_aging(const PriorityQueues* pq) {
+    long long earliest = -1;
+    for (int p = PRIO_USER_MAX + 1; p < PRIO_LEVELS; p++) {
+        if (pq->head[p] == -1) continue;
+        long long t = pq->ready_since[pq->head[p]] + PRIO_AGING_INTERVAL;
+        if (earliest == -1 || t < earliest) earliest = t;
+    }
+    return earliest;
+}
+
+/**
+ * @brief Builds a process table from trace records (see workload.h).
+ * @return Newly allocated process array; ids are 0-based input positions.
+ */
+static inline Process* processes_from_records(const WorkloadRecord recs[], int n) {
+    Process* proc = (Process*)malloc((n ? n : 1) * sizeof(Process));
+    for (int i = 0; i < n; i++) {
+        proc[i].id = i;
+        proc[i].arrival_time = recs[i].arrival_time;
+        proc[i].burst_time = recs[i].burst_time;
+        proc[i].nice = recs[i].nice;
+        proc[i].static_priority = proc[i].priority = 120 + recs[i].nice;
+        proc[i].remaining_time = recs[i].burst_time;
+    }
+    return proc;
+}
+
+/**
+ * @brief Loads a CSV or binary trace straight into a process table.
+ * @return Newly allocated process array, or NULL on error (message on stderr).
+ */
+static inline Process* load_processes(const char* path, int* n) {
+    WorkloadRecord* recs = load_workload(path, n);
+    if (recs == NULL) return NULL;
+    Process* proc = processes_from_records(recs, *n);
+    free(recs);
+    return proc;
+}
+
+/**
+ * @brief Averages waiting and turnaround time over all processes.
+ */
+static inline void compute_averages(const Process proc[], int n, double* avg_wt, double* avg_tat) {
+    double total_wt = 0, total_tat = 0;
+    for (int i = 0; i < n; i++) {
+        total_wt += proc[i].waiting_time;
+        total_tat += proc[i].turnaround_time;
+    }
+    *avg_wt = total_wt / n;
+    *avg_tat = total_tat / n;
+}
+
+/**
+ * @brief Prints a formatted table of results
+ */
+static inline void print_results(Process proc[], int n, const char* algorithm_name) {
+    double total_wt = 0, total_tat = 0;
+
+    printf("\n---=== [ %s ] ===---\n", algorithm_name);
+    printf("PID\tAT\tBT\tCT\tTAT\tWT\n");
+    printf("--------------------------------------------------\n");
+
+    for (int i = 0; i < n; i++) {
+        printf("P%d\t%d\t%d\t%lld\t%lld\t%lld\n",
+               proc[i].id, proc[i].arrival_time, proc[i].burst_time,
+               proc[i].completion_time, proc[i].turnaround_time, proc[i].waiting_time);
+        
+        total_wt += proc[i].waiting_time;
+        total_tat += proc[i].turnaround_time;
+    }
+    
+    printf("--------------------------------------------------\n");
+    printf("Average Waiting Time:    %.2f\n", total_wt / n);
+    printf("Average Turnaround Time: %.2f\n\n", total_tat / n);
+}
+
+/*
+ * Streaming latency summaries
+ * ---------------------------
+ * A log-linear histogram in the style of HdrHistogram: values below
+ * HIST_SUB_COUNT get one bucket each, and every power of two above that is
+ * split into HIST_SUB_COUNT / 2 linear buckets, so a recorded value is off by
+ * less than 1% and the memory is fixed no matter how many values arrive.
+ * Percentiles are read back as the highest value of the matching bucket.
+ */
+
+#define HIST_SUB_BITS 8
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS ((64 - HIST_SUB_BITS + 1) * (HIST_SUB_COUNT / 2))
+
+typedef struct {
+    long long counts[HIST_BUCKETS];
+    long long total;  // Number of recorded values
+    long long max;
+    double sum;       // For the exact mean
+} LatencyHistogram;
+
+/* Per-run latency distributions, filled in as processes complete */
+typedef struct {
+    LatencyHistogram response;
+    LatencyHistogram waiting;
+    LatencyHistogram turnaround;
+} SchedMetrics;
+
+static inline int hist_index(long long value) {
+    if (value < HIST_SUB_COUNT) return (int)value;
+    int shift = (63 - __builtin_clzll((unsigned long long)value)) - (HIST_SUB_BITS - 1);
+    return shift * (HIST_SUB_COUNT / 2) + (int)(value >> shift);
+}
+
+// Largest value that maps to bucket 'index'
+static inline long long hist_bucket_max(int index) {
+    if (index < HIST_SUB_COUNT) return index;
+    int shift = index / (HIST_SUB_COUNT / 2) - 1;
+    long long sub = index - shift * (HIST_SUB_COUNT / 2);
+    return ((sub + 1) << shift) - 1;
+}
+
+static inline void hist_record(LatencyHistogram* h, long long value) {
+    if (value < 0) value = 0;
+    h->counts[hist_index(value)]++;
+    h->total++;
+    h->sum += value;
+    if (value > h->max) h->max = value;
+}
+
+/**
+ * @brief Value at percentile 'pct' (0..100): the smallest bucket holding at
+ *        least pct% of the values, reported as that bucket's upper bound.
+ */
+static inline long long hist_percentile(const LatencyHistogram* h, double pct) {
+    long long rank = (long long)(pct / 100.0 * h->total + 0.999999);
+    long long seen = 0;
+    if (rank < 1) rank = 1;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            long long value = hist_bucket_max(i);
+            return value < h->max ? value : h->max;
+        }
+    }
+    return h->max;
+}
+
+/**
+ * @brief Adds one completed process to the running summaries.
+ */
+static inline void metrics_record(SchedMetrics* m, const Process* p) {
+    hist_record(&m->response, p->response_time);
+    hist_record(&m->waiting, p->waiting_time);
+    hist_record(&m->turnaround, p->turnaround_time);
+}
+
+/**
+ * @brief Prints mean and tail percentiles of response, waiting and turnaround time.
+ */
+static inline void print_summary(const SchedMetrics* m, const char* algorithm_name) {
+    const LatencyHistogram* rows[3] = { &m->response, &m->waiting, &m->turnaround };
+    const char* names[3] = { "Response", "Waiting", "Turnaround" };
+
+    printf("\n---=== [ %s ] ===---\n", algorithm_name);
+    printf("Processes: %lld\n", m->turnaround.total);
+    printf("Metric\t\tMean\tp50\tp90\tp99\tp99.9\tMax\n");
+    printf("--------------------------------------------------\n");
+    for (int r = 0; r < 3; r++) {
+        const LatencyHistogram* h = rows[r];
+        printf("%s\t%s%.2f\t%lld\t%lld\t%lld\t%lld\t%lld\n", names[r], r == 1 ? "\t" : "",
+               h->total ? h->sum / h->total : 0.0, hist_percentile(h, 50), hist_percentile(h, 90),
+               hist_percentile(h, 99), hist_percentile(h, 99.9), h->max);
+    }
+    printf("--------------------------------------------------\n\n");
+}
+
+/**
+ * @brief Records the response time when a process first gets the CPU.
+ */
+static inline void note_first_run(Process* p, long long now) {
+    if (p->remaining_time == p->burst_time) p->response_time = now - p->arrival_time;
+}
+
+/*
+ * Scheduler engine
+ * ----------------
+ * sched_simulate() owns the clock, the arrival order and the running process.
+ * A policy only manages its run queue through these hooks:
+ *
+ *   admit          a process arrived at 'now'
+ *   pick_next      remove and return the next process to run (-1 if none is
+ *                  ready) and set *slice to the time it may run before the
+ *                  policy wants the CPU back (SCHED_NO_SLICE = until done)
+ *   should_preempt after arrivals, whether a waiting process should take
+ *                  the CPU from 'running' (NULL = never preempt)
+ *   requeue        the running process goes back to the run queue, either
+ *                  preempted (slice_left > 0) or with its slice used up
+ *   on_tick        'running' just ran for 'ran' time units (accounting)
+ *   on_complete    the running process finished
+ *   next_event     the next time the policy needs control without an
+ *                  arrival, e.g. to age processes (-1 = none)
+ *
+ * on_tick, on_complete, next_event and should_preempt may be NULL. The clock
+ * jumps from event to event (arrival, completion, slice end or policy
+ * event), so a simulation costs O(events x hook cost).
+ */
+
+#define SCHED_NO_SLICE LLONG_MAX
+
+typedef struct {
+    const char *name;    // Short name for tables, e.g. "SRTF"
+    const char *title;   // Heading printed above the results
+    int uses_quantum;    // 1 if the quantum changes the schedule
+    void* (*create)(Process proc[], int n, int quantum);
+    void (*destroy)(void* state);
+    void (*admit)(void* state, int i, long long now);
+    int (*pick_next)(void* state, long long now, long long* slice);
+    int (*should_preempt)(void* state, int running, long long now);
+    void (*requeue)(void* state, int i, long long now, long long slice_left);
+    void (*on_tick)(void* state, int running, long long ran, long long now);
+    void (*on_complete)(void* state, int i, long long now);
+    long long (*next_event)(void* state, long long now);
+} SchedPolicy;
+
+/**
+ * @brief Runs one policy over the process table and fills in the metrics.
+ * @param metrics If not NULL, every completion is also added to these summaries.
+ * @return Number of dispatch decisions made.
+ */
+static inline long long sched_simulate(const SchedPolicy* policy, Process proc[], int n, int quantum,
+                                       SchedMetrics* metrics) {
+    long long current_time = 0;
+    long long dispatches = 0;
+    long long slice_left = 0;
+    int completed = 0;
+    int next_arrival = 0; // Position in 'order' of the next process to arrive
+    int running = -1;     // Index of the process on the CPU, -1 if idle
+
+    int* order = sort_by_arrival(proc, n);
+    void* state = policy->create(proc, n, quantum);
+
+    while (completed != n) {
+        // Admit every process that has arrived by now.
+        while (next_arrival < n && proc[order[next_arrival]].arrival_time <= current_time) {
+            policy->admit(state, order[next_arrival++], current_time);
+        }
+
+        if (running != -1 && policy->should_preempt != NULL &&
+            policy->should_preempt(state, running, current_time)) {
+            policy->requeue(state, running, current_time, slice_left);
+            running = -1;
+        }
+
+        if (running == -1) {
+            running = policy->pick_next(state, current_time, &slice_left);
+            if (running == -1) {
+                // No process is ready, CPU is idle until the next arrival.
+                current_time = proc[order[next_arrival]].arrival_time;
+                continue;
+            }
+            dispatches++;
+        }
+
+        // Run until completion, the end of the slice, the next arrival or a policy event.
+        long long run = proc[running].remaining_time;
+        if (run > slice_left) run = slice_left;
+        if (next_arrival < n && proc[order[next_arrival]].arrival_time - current_time < run) {
+            run = proc[order[next_arrival]].arrival_time - current_time;
+        }
+        if (policy->next_event != NULL) {
+            long long event_time = policy->next_event(state, current_time);
+            if (event_time != -1 && event_time - current_time < run) run = event_time - current_time;
+        }
+
+        note_first_run(&proc[running], current_time);
+        current_time += run;
+        slice_left -= run;
+        proc[running].remaining_time -= run;
+        if (policy->on_tick != NULL) policy->on_tick(state, running, run, current_time);
+
+        if (proc[running].remaining_time == 0) {
+            proc[running].completion_time = current_time;
+            proc[running].turnaround_time = proc[running].completion_time - proc[running].arrival_time;
+            proc[running].waiting_time = proc[running].turnaround_time - proc[running].burst_time;
+            if (metrics != NULL) metrics_record(metrics, &proc[running]);
+            if (policy->on_complete != NULL) policy->on_complete(state, running, current_time);
+            completed++;
+            running = -1;
+        } else if (slice_left == 0) {
+            policy->requeue(state, running, current_time, 0);
+            running = -1;
+        }
+    }
+
+    policy->destroy(state);
+    free(order);
+    return dispatches;
+}
+
+/*
+ * SRTF policy: ready processes sit in a min-heap keyed on remaining time. A
+ * process runs until it completes or an arrival has less remaining time.
+ */
+
+static inline void* srtf_create(Process proc[], int n, int quantum) {
+    ReadyHeap* heap = (ReadyHeap*)malloc(sizeof(ReadyHeap));
+    (void)quantum;
+    heap_init(heap, proc, n);
+    return heap;
+}
+
+static inline void srtf_destroy(void* state) {
+    ReadyHeap* heap = (ReadyHeap*)state;
+    free(heap->idx);
+    free(heap);
+}
+
+static inline void srtf_admit(void* state, int i, long long now) {
+    (void)now;
+    heap_push((ReadyHeap*)state, i);
+}
+
+static inline int srtf_pick_next(void* state, long long now, long long* slice) {
+    ReadyHeap* heap = (ReadyHeap*)state;
+    (void)now;
+    if (heap->size == 0) return -1;
+    *slice = SCHED_NO_SLICE;
+    return heap_pop(heap);
+}
+
+// Preempt when the best waiting process beats the running one (ties to the lower index).
+static inline int srtf_should_preempt(void* state, int running, long long now) {
+    ReadyHeap* heap = (ReadyHeap*)state;
+    (void)now;
+    return heap->size > 0 && heap_less(heap, heap->idx[0], running);
+}
+
+static inline void srtf_requeue(void* state, int i, long long now, long long slice_left) {
+    (void)now;
+    (void)slice_left;
+    heap_push((ReadyHeap*)state, i);
+}
+
+static const SchedPolicy srtf_policy = {
+    "SRTF", "Shortest Job First (Preemptive - SRTF)", 0,
+    srtf_create, srtf_destroy, srtf_admit, srtf_pick_next, srtf_should_preempt,
+    srtf_requeue, NULL, NULL, NULL
+};
+
+/*
+ * Round Robin policy: a FIFO ready queue and a fixed quantum. A process whose
+ * quantum expires goes to the back, behind any process that arrived at the
+ * same instant, so its requeue is deferred until the next pick.
+ */
+
+typedef struct {
+    ReadyQueue queue;
+    int quantum;
+    int expired;  // Process whose quantum just ran out, -1 if none
+} RoundRobinState;
+
+static inline void* rr_create(Process proc[], int n, int quantum) {
+    RoundRobinState* rr = (RoundRobinState*)malloc(sizeof(RoundRobinState));
+    (void)proc;
+    queue_init(&rr->queue, n);
+    rr->quantum = quantum;
+    rr->expired = -1;
+    return rr;
+}
+
+static inline void rr_destroy(void* state) {
+    RoundRobinState* rr = (RoundRobinState*)state;
+    free(rr->queue.idx);
+    free(rr);
+}
+
+static inline void rr_admit(void* state, int i, long long now) {
+    (void)now;
+    queue_push(&((RoundRobinState*)state)->queue, i);
+}
+
+static inline int rr_pick_next(void* state, long long now, long long* slice) {
+    RoundRobinState* rr = (RoundRobinState*)state;
+    (void)now;
+    if (rr->expired != -1) {
+        queue_push(&rr->queue, rr->expired); // Preempted: back of the queue
+        rr->expired = -1;
+    }
+    if (rr->queue.size == 0) return -1;
+    *slice = rr->quantum;
+    return queue_pop(&rr->queue);
+}
+
+static inline void rr_requeue(void* state, int i, long long now, long long slice_left) {
+    (void)now;
+    (void)slice_left;
+    ((RoundRobinState*)state)->expired = i;
+}
+
+static const SchedPolicy round_robin_policy = {
+    "RR", "Round Robin", 1,
+    rr_create, rr_destroy, rr_admit, rr_pick_next, NULL,
+    rr_requeue, NULL, NULL, NULL
+};
+
+/*
+ * CFS policy: runnable processes sit in a red-black tree keyed on vruntime.
+ * The leftmost (smallest vruntime) process runs for a slice of
+ * CFS_TARGET_LATENCY shared in proportion to its weight (at least
+ * CFS_MIN_GRANULARITY), and its vruntime advances by the time run scaled by
+ * NICE_0_LOAD / weight. New arrivals start at the queue's min_vruntime and
+ * preempt the running process if they trail it by more than
+ * CFS_WAKEUP_GRANULARITY. Each hook costs O(log n).
+ */
+
+typedef struct {
+    RbTree tree;
+    Process *proc;
+    long long min_vruntime;
+    long long total_weight; // Sum of weights of runnable processes, running one included
+    int nr_running;
+} CfsState;
+
+static inline void* cfs_create(Process proc[], int n, int quantum) {
+    CfsState* cfs = (CfsState*)malloc(sizeof(CfsState));
+    (void)quantum;
+    rb_init(&cfs->tree, n);
+    cfs->proc = proc;
+    cfs->min_vruntime = 0;
+    cfs->total_weight = 0;
+    cfs->nr_running = 0;
+    return cfs;
+}
+
+static inline void cfs_destroy(void* state) {
+    CfsState* cfs = (CfsState*)state;
+    rb_free(&cfs->tree);
+    free(cfs);
+}
+
+// Arrivals are placed at the current min_vruntime.
+static inline void cfs_admit(void* state, int i, long long now) {
+    CfsState* cfs = (CfsState*)state;
+    (void)now;
+    cfs->tree.vruntime[i] = cfs->min_vruntime;
+    rb_insert(&cfs->tree, i);
+    cfs->total_weight += cfs_nice_to_weight[cfs->proc[i].nice + 20];
+    cfs->nr_running++;
+}
+
+static inline int cfs_pick_next(void* state, long long now, long long* slice) {
+    CfsState* cfs = (CfsState*)state;
+    (void)now;
+    if (cfs->tree.leftmost == cfs->tree.nil) return -1;
+    int i = cfs->tree.leftmost;
+    rb_erase(&cfs->tree, i);
+
+    // Slice: this process's weighted share of the scheduling period.
+    long long period = CFS_TARGET_LATENCY;
+    if (cfs->nr_running > CFS_TARGET_LATENCY / CFS_MIN_GRANULARITY) {
+        period = (long long)cfs->nr_running * CFS_MIN_GRANULARITY;
+    }
+    *slice = period * cfs_nice_to_weight[cfs->proc[i].nice + 20] / cfs->total_weight;
+    if (*slice < CFS_MIN_GRANULARITY) *slice = CFS_MIN_GRANULARITY;
+    return i;
+}
+
+/*
+ * Wakeup preemption. Only arrivals interrupt a CFS slice, and a newcomer at
+ * min_vruntime is always the leftmost node, so comparing against the
+ * leftmost is the same as comparing against the new arrival.
+ */
+static inline int cfs_should_preempt(void* state, int running, long long now) {
+    CfsState* cfs = (CfsState*)state;
+    const long long wakeup_gran = (long long)CFS_WAKEUP_GRANULARITY << CFS_VRUNTIME_SHIFT;
+    (void)now;
+    return cfs->tree.leftmost != cfs->tree.nil &&
+           cfs->tree.vruntime[running] - cfs->tree.vruntime[cfs->tree.leftmost] > wakeup_gran;
+}
+
+static inline void cfs_requeue(void* state, int i, long long now, long long slice_left) {
+    (void)now;
+    (void)slice_left;
+    rb_insert(&((CfsState*)state)->tree, i);
+}
+
+static inline void cfs_on_tick(void* state, int running, long long ran, long long now) {
+    CfsState* cfs = (CfsState*)state;
+    RbTree* tree = &cfs->tree;
+    (void)now;
+    tree->vruntime[running] += (ran << CFS_VRUNTIME_SHIFT) * CFS_NICE_0_LOAD /
+                               cfs_nice_to_weight[cfs->proc[running].nice + 20];
+
+    // min_vruntime only moves forward, tracking the smallest runnable vruntime.
+    long long floor_vr = tree->vruntime[running];
+    if (tree->leftmost != tree->nil && tree->vruntime[tree->leftmost] < floor_vr) {
+        floor_vr = tree->vruntime[tree->leftmost];
+    }
+    if (floor_vr > cfs->min_vruntime) cfs->min_vruntime = floor_vr;
+}
+
+static inline void cfs_on_complete(void* state, int i, long long now) {
+    CfsState* cfs = (CfsState*)state;
+    (void)now;
+    cfs->total_weight -= cfs_nice_to_weight[cfs->proc[i].nice + 20];
+    cfs->nr_running--;
+}
+
+static const SchedPolicy cfs_policy = {
+    "CFS", "Completely Fair Scheduler (CFS)", 0,
+    cfs_create, cfs_destroy, cfs_admit, cfs_pick_next, cfs_should_preempt,
+    cfs_requeue, cfs_on_tick, cfs_on_complete, NULL
+};
+
+/*
+ * Priority policy: the process at the head of the highest non-empty queue
+ * runs for its time slice. It is preempted when a higher-priority process
+ * arrives or ages past it and keeps the rest of its slice for later. On
+ * slice expiry its priority resets to the static value and it rejoins the
+ * tail of that queue. Aging is applied at every event, and next_event stops
+ * the clock at the next aging point, so time never has to tick.
+ */
+
+typedef struct {
+    PriorityQueues pq;
+    Process *proc;
+    int n;
+    int quantum;
+    int linear_pick; // Pick with prio_pick_linear() instead of the bitmap
+} PriorityState;
+
+static inline void* priority_create_with(Process proc[], int n, int quantum, int linear_pick) {
+    PriorityState* ps = (PriorityState*)malloc(sizeof(PriorityState));
+    PriorityQueues* pq = &ps->pq;
+
+    memset(pq->bitmap, 0, sizeof(pq->bitmap));
+    for (int p = 0; p < PRIO_LEVELS; p++) pq->head[p] = pq->tail[p] = -1;
+    pq->next = (int*)malloc(n * sizeof(int));
+    pq->prev = (int*)malloc(n * sizeof(int));
+    pq->ready_since = (long long*)malloc(n * sizeof(long long));
+    pq->seq = (long long*)malloc(n * sizeof(long long));
+    pq->slice_left = (long long*)calloc(n, sizeof(long long));
+    pq->queued = (int*)calloc(n, sizeof(int));
+    pq->next_seq = 0;
+    ps->proc = proc;
+    ps->n = n;
+    ps->quantum = quantum;
+    ps->linear_pick = linear_pick;
+    return ps;
+}
+
+static inline void* priority_create(Process proc[], int n, int quantum) {
+    return priority_create_with(proc, n, quantum, 0);
+}
+
+static inline void* priority_linear_create(Process proc[], int n, int quantum) {
+    return priority_create_with(proc, n, quantum, 1);
+}
+
+static inline void priority_destroy(void* state) {
+    PriorityState* ps = (PriorityState*)state;
+    free(ps->pq.next);
+    free(ps->pq.prev);
+    free(ps->pq.ready_since);
+    free(ps->pq.seq);
+    free(ps->pq.slice_left);
+    free(ps->pq.queued);
+    free(ps);
+}
+
+static inline void priority_admit(void* state, int i, long long now) {
+    PriorityState* ps = (PriorityState*)state;
+    ps->proc[i].priority = ps->proc[i].static_priority;
+    prio_enqueue(&ps->pq, ps->proc, i, now);
+}
+
+static inline int priority_pick_next(void* state, long long now, long long* slice) {
+    PriorityState* ps = (PriorityState*)state;
+    prio_age(&ps->pq, ps->proc, now);
+    if (prio_highest(&ps->pq) == -1) return -1;
+
+    int i = ps->linear_pick ? prio_pick_linear(&ps->pq, ps->proc, ps->n) : ps->pq.head[prio_highest(&ps->pq)];
+    prio_dequeue(&ps->pq, ps->proc, i);
+    *slice = ps->pq.slice_left[i];
+    if (*slice == 0) *slice = priority_timeslice(ps->proc[i].static_priority, ps->quantum);
+    return i;
+}
+
+// Preempt if something better is waiting after aging.
+static inline int priority_should_preempt(void* state, int running, long long now) {
+    PriorityState* ps = (PriorityState*)state;
+    prio_age(&ps->pq, ps->proc, now);
+    int best = prio_highest(&ps->pq);
+    return best != -1 && best < ps->proc[running].priority;
+}
+
+static inline void priority_requeue(void* state, int i, long long now, long long slice_left) {
+    PriorityState* ps = (PriorityState*)state;
+    if (slice_left == 0) ps->proc[i].priority = ps->proc[i].static_priority;
+    ps->pq.slice_left[i] = slice_left; // A preempted process keeps its remaining slice
+    prio_enqueue(&ps->pq, ps->proc, i, now);
+}
+
+static inline long long priority_next_event(void* state, long long now) {
+    (void)now;
+    return prio_next_aging(&((PriorityState*)state)->pq);
+}
+
+static const SchedPolicy priority_policy = {
+    "Priority", "Priority (O(1) bitmap, with aging)", 1,
+    priority_create, priority_destroy, priority_admit, priority_pick_next, priority_should_preempt,
+    priority_requeue, NULL, NULL, priority_next_event
+};
+
+/* Same schedule as priority_policy, dispatched by a linear scan (for benchmarking) */
+static const SchedPolicy priority_linear_policy = {
+    "Priority-linear", "Priority (linear scan, with aging)", 1,
+    priority_linear_create, priority_destroy, priority_admit, priority_pick_next, priority_should_preempt,
+    priority_requeue, NULL, NULL, priority_next_event
+};
+
+/* Policies selectable by name; the order is the order of a full run */
+static const SchedPolicy* const sched_policies[] = {
+    &srtf_policy, &round_robin_policy, &cfs_policy, &priority_policy, &priority_linear_policy
+};
+
+/**
+ * @brief Looks a policy up by its short name (case-insensitive), NULL if unknown.
+ */
+static inline const SchedPolicy* sched_find_policy(const char* name) {
+    for (size_t i = 0; i < sizeof(sched_policies) / sizeof(sched_policies[0]); i++) {
+        if (strcasecmp(sched_policies[i]->name, name) == 0) return sched_policies[i];
+    }
+    return NULL;
+}
+
+
+/**
+ * @brief Simulates one policy and prints the results under its title.
+ * @param summary 0 prints one row per process; 1 prints only the percentile
+ *        summary, which stays readable at millions of processes.
+ */
+static inline void sched_run(const SchedPolicy* policy, Process proc[], int n, int quantum, int summary) {
+    if (summary) {
+        SchedMetrics* metrics = (SchedMetrics*)calloc(1, sizeof(SchedMetrics));
+        sched_simulate(policy, proc, n, quantum, metrics);
+        print_summary(metrics, policy->title);
+        free(metrics);
+    } else {
+        sched_simulate(policy, proc, n, quantum, NULL);
+        print_results(proc, n, policy->title);
+    }
+}
+
+#endif // SCHED_ENGINE_H
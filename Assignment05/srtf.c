@@ -9,79 +9,56 @@
  * Key Concepts:
  * - Preemptive: A running process can be interrupted if a new process
  *   arrives with a shorter remaining burst time.
- * - The ready queue is always searched for the process with the least
- *   remaining time to execute next.
+ * - The ready queue is a min-heap keyed on remaining time, so the process
+ *   with the least remaining time is always at the top.
+ * - Event-driven: time jumps straight to the next arrival or completion
+ *   instead of advancing one unit at a time.
+ * - The simulation itself is srtf_policy on the shared engine in
+ *   sched_engine.h; this file only reads the input.
  *
  * Performance Metrics Calculated:
  * - Completion Time (CT): The time at which a process finishes execution.
  * - Turnaround Time (TAT): CT - Arrival Time.
  * - Waiting Time (WT): TAT - Burst Time.
+ *
+ * Usage: ./srtf            (interactive input)
+ *        ./srtf FILE       (CSV or binary trace, see workload.h)
+ * Compile with: gcc srtf.c -o srtf -lm
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include "sched_engine.h"
 
-int main() {
+int main(int argc, char* argv[]) {
     int n, i;
-    printf("Enter the number of processes (<= 20): ");
-    scanf("%d", &n);
-    if (n <= 0 || n > 20) { printf("Invalid n\n"); return 0; }
-
-    int at[20], bt[20], rem[20], temp[20];
-    int ct[20], wt[20], tat[20];
-    int time = 0, count = 0;
-    float avg_wt = 0, avg_tat = 0;
+    Process* proc;
 
-    printf("\nEnter Arrival Time and Burst Time for each process:\n");
-    for (i = 0; i < n; i++) {
-        printf("P%d Arrival Time: ", i + 1);
-        scanf("%d", &at[i]);
-        printf("P%d Burst Time: ", i + 1);
-        scanf("%d", &bt[i]);
-        if (bt[i] < 0 || at[i] < 0) { printf("Invalid input\n"); return 0; }
-        temp[i] = bt[i];
-        rem[i] = bt[i]; // remaining time
-    }
+    if (argc > 1) {
+        proc = load_processes(argv[1], &n);
+        if (proc == NULL) return 1;
+        if (n <= 0) { printf("Invalid n\n"); free(proc); return 0; }
+    } else {
+        printf("Enter the number of processes: ");
+        scanf("%d", &n);
+        if (n <= 0) { printf("Invalid n\n"); return 0; }
 
-    printf("\nProcess\tAT\tBT\tCT\tTAT\tWT\n");
-    time = 0;
-    count = 0;
-
-    while (count < n) {
-        int smallest = -1;
-        // find process with smallest remaining time among arrived and unfinished
+        WorkloadRecord* recs = calloc(n, sizeof(WorkloadRecord));
+        printf("\nEnter Arrival Time and Burst Time for each process:\n");
         for (i = 0; i < n; i++) {
-            if (at[i] <= time && rem[i] > 0) {
-                if (smallest == -1 || rem[i] < rem[smallest]) {
-                    smallest = i;
-                }
-            }
-        }
-
-        if (smallest == -1) {
-            // No process is ready at this time, CPU idle -> advance time
-            time++;
-            continue;
-        }
-
-        // execute smallest for 1 unit
-        rem[smallest]--;
-        time++;
-
-        if (rem[smallest] == 0) {
-            count++;
-            ct[smallest] = time; // finished at current time
-            tat[smallest] = ct[smallest] - at[smallest];
-            wt[smallest] = tat[smallest] - temp[smallest];
-            avg_wt += wt[smallest];
-            avg_tat += tat[smallest];
+            printf("P%d Arrival Time: ", i + 1);
+            scanf("%d", &recs[i].arrival_time);
+            printf("P%d Burst Time: ", i + 1);
+            scanf("%d", &recs[i].burst_time);
+            if (recs[i].burst_time < 0 || recs[i].arrival_time < 0) { printf("Invalid input\n"); free(recs); return 0; }
         }
+        proc = processes_from_records(recs, n);
+        free(recs);
     }
 
-    for (i = 0; i < n; i++) {
-        printf("P%d\t%d\t%d\t%d\t%d\t%d\n", i + 1, at[i], temp[i], ct[i], tat[i], wt[i]);
-    }
-    printf("\nAverage Waiting Time = %.2f", avg_wt / n);
-    printf("\nAverage Turnaround Time = %.2f\n", avg_tat / n);
+    for (i = 0; i < n; i++) proc[i].id = i + 1; // number processes from P1
+    sched_run(&srtf_policy, proc, n, 0, 0);
 
+    free(proc);
     return 0;
-}
\ No newline at end of file
+}
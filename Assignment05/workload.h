@@ -0,0 +1,263 @@
+/*
+ * workload.h
+ * ==========
+ * Non-interactive workload input for the CPU scheduling simulators.
+ *
+ * Instead of typing each process with scanf, a workload can come from:
+ * 1. A trace file, memory-mapped and parsed in place (no per-line stdio):
+ *    - CSV:    one "arrival_time,burst_time[,nice]" record per line. Lines
+ *              that do not start with a digit (headers, '#' comments) are
+ *              skipped; a missing nice value defaults to 0.
+ *    - Binary: 16-byte header ("PTRC", uint32 version, uint64 count)
+ *              followed by 'count' records, little endian. Version 1 records
+ *              are int32 arrival_time and int32 burst_time; version 2 adds
+ *              an int32 nice value.
+ * 2. A synthetic generator producing Poisson arrivals (exponentially
+ *    distributed inter-arrival gaps) with heavy-tailed Pareto burst times.
+ *
+ * Every function here is static inline so each simulator can include this header
+ * directly and still be compiled on its own (gcc srtf.c).
+ */
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define WORKLOAD_MAGIC "PTRC"
+#define WORKLOAD_VERSION 2
+#define WORKLOAD_HEADER_SIZE 16
+#define WORKLOAD_MAX_BURST 1000000 // Cap for generated Pareto bursts
+
+/* One process record as stored in a trace */
+typedef struct {
+    int arrival_time;
+    int burst_time;
+    int nice;          // -20 (highest priority) .. 19 (lowest), 0 by default
+} WorkloadRecord;
+
+/**
+ * @brief Parses a non-negative decimal integer at *p, advancing *p past it.
+ * @return 0 on success, -1 if no digits were found or the value overflows int.
+ */
+static inline int parse_int(const char** p, const char* end, int* out) {
+    const char* s = *p;
+    long long value = 0;
+
+    if (s >= end || *s < '0' || *s > '9') return -1;
+    while (s < end && *s >= '0' && *s <= '9') {
+        value = value * 10 + (*s - '0');
+        if (value > 0x7fffffff) return -1;
+        s++;
+    }
+    *p = s;
+    *out = (int)value;
+    return 0;
+}
+
+/**
+ * @brief Parses a memory-mapped CSV trace.
+ * @return Newly allocated record array, or NULL on a malformed line.
+ */
+static inline WorkloadRecord* parse_csv_workload(const char* data, size_t len, int* n) {
+    const char* p = data;
+    const char* end = data + len;
+    long lines = 1;
+    int count = 0, line_no = 0;
+
+    // Upper bound on the number of records: one per line.
+    for (const char* q = data; (q = memchr(q, '\n', end - q)) != NULL; q++) lines++;
+    WorkloadRecord* recs = (WorkloadRecord*)malloc(lines * sizeof(WorkloadRecord));
+
+    while (p < end) {
+        const char* eol = memchr(p, '\n', end - p);
+        if (eol == NULL) eol = end;
+        line_no++;
+
+        if (*p >= '0' && *p <= '9') {
+            WorkloadRecord r;
+            if (parse_int(&p, eol, &r.arrival_time) != 0) goto bad_line;
+            while (p < eol && (*p == ',' || *p == ' ' || *p == '\t')) p++;
+            if (parse_int(&p, eol, &r.burst_time) != 0) goto bad_line;
+            r.nice = 0;
+            while (p < eol && (*p == ',' || *p == ' ' || *p == '\t')) p++;
+            if (p < eol && (*p == '-' || (*p >= '0' && *p <= '9'))) {
+                int negative = (*p == '-');
+                if (negative) p++;
+                if (parse_int(&p, eol, &r.nice) != 0) goto bad_line;
+                if (negative) r.nice = -r.nice;
+                if (r.nice < -20 || r.nice > 19) goto bad_line;
+            }
+            recs[count++] = r;
+        }
+        p = eol + 1;
+    }
+    *n = count;
+    return recs;
+
+bad_line:
+    fprintf(stderr, "Malformed trace record on line %d\n", line_no);
+    free(recs);
+    return NULL;
+}
+
+/**
+ * @brief Parses a memory-mapped binary trace.
+ * @return Newly allocated record array, or NULL if the header or size is wrong
+ *         or a record is out of range.
+ */
+static inline WorkloadRecord* parse_binary_workload(const char* data, size_t len, int* n) {
+    uint32_t version;
+    uint64_t count;
+
+    memcpy(&version, data + 4, sizeof(version));
+    memcpy(&count, data + 8, sizeof(count));
+    size_t record_size = (version == 1) ? 2 * sizeof(int32_t) : sizeof(WorkloadRecord);
+    if (version < 1 || version > WORKLOAD_VERSION || count > 0x7fffffff ||
+        len != WORKLOAD_HEADER_SIZE + count * record_size) {
+        fprintf(stderr, "Corrupt binary trace header\n");
+        return NULL;
+    }
+
+    WorkloadRecord* recs = (WorkloadRecord*)malloc((count ? count : 1) * sizeof(WorkloadRecord));
+    if (version == WORKLOAD_VERSION) {
+        memcpy(recs, data + WORKLOAD_HEADER_SIZE, count * sizeof(WorkloadRecord));
+    } else {
+        const char* src = data + WORKLOAD_HEADER_SIZE;
+        for (uint64_t i = 0; i < count; i++, src += record_size) {
+            memcpy(&recs[i].arrival_time, src, sizeof(int32_t));
+            memcpy(&recs[i].burst_time, src + sizeof(int32_t), sizeof(int32_t));
+            recs[i].nice = 0;
+        }
+    }
+    // Same limits as the CSV parser: no negative times, nice in -20..19.
+    for (uint64_t i = 0; i < count; i++) {
+        if (recs[i].arrival_time < 0 || recs[i].burst_time < 0 ||
+            recs[i].nice < -20 || recs[i].nice > 19) {
+            fprintf(stderr, "Corrupt binary trace record %llu\n", (unsigned long long)i);
+            free(recs);
+            return NULL;
+        }
+    }
+    *n = (int)count;
+    return recs;
+}
+
+/**
+ * @brief Loads a CSV or binary trace through mmap; the format is detected from the magic.
+ * @param path Trace file to read.
+ * @param n Receives the number of records.
+ * @return Newly allocated record array, or NULL on error (message on stderr).
+ */
+static inline WorkloadRecord* load_workload(const char* path, int* n) {
+    struct stat st;
+    WorkloadRecord* recs = NULL;
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        if (fd >= 0) close(fd);
+        return NULL;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        *n = 0;
+        return (WorkloadRecord*)malloc(sizeof(WorkloadRecord));
+    }
+
+    const char* data = (const char*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return NULL;
+    }
+    madvise((void*)data, st.st_size, MADV_SEQUENTIAL);
+
+    if (st.st_size >= WORKLOAD_HEADER_SIZE && memcmp(data, WORKLOAD_MAGIC, 4) == 0) {
+        recs = parse_binary_workload(data, st.st_size, n);
+    } else {
+        recs = parse_csv_workload(data, st.st_size, n);
+    }
+
+    munmap((void*)data, st.st_size);
+    return recs;
+}
+
+/**
+ * @brief Writes records as a binary trace, the fastest format to load back.
+ * @return 0 on success, -1 on I/O error.
+ */
+static inline int write_workload_binary(const char* path, const WorkloadRecord* recs, int n) {
+    FILE* fp = fopen(path, "wb");
+    uint32_t version = WORKLOAD_VERSION;
+    uint64_t count = (uint64_t)n;
+
+    if (fp == NULL) {
+        perror(path);
+        return -1;
+    }
+    fwrite(WORKLOAD_MAGIC, 1, 4, fp);
+    fwrite(&version, sizeof(version), 1, fp);
+    fwrite(&count, sizeof(count), 1, fp);
+    fwrite(recs, sizeof(WorkloadRecord), n, fp);
+    if (fclose(fp) != 0) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief splitmix64 step: small, fast and reproducible across platforms.
+ */
+static inline uint64_t workload_rand(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Uniform double in (0, 1], never 0 so log() and pow() stay finite.
+ */
+static inline double workload_uniform(uint64_t* state) {
+    return ((workload_rand(state) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Generates a synthetic workload.
+ * @param n Number of processes.
+ * @param rate Mean arrivals per time unit (Poisson process).
+ * @param alpha Pareto shape; smaller means a heavier tail (alpha <= 1 has no finite mean).
+ * @param min_burst Pareto scale, i.e. the shortest possible burst.
+ * @param seed Random seed, so runs can be reproduced.
+ * @return Newly allocated record array sorted by arrival time.
+ */
+static inline WorkloadRecord* generate_workload(int n, double rate, double alpha, int min_burst, uint64_t seed) {
+    WorkloadRecord* recs = (WorkloadRecord*)malloc((n ? n : 1) * sizeof(WorkloadRecord));
+    uint64_t state = seed;
+    double clock = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        // Exponential inter-arrival gap with mean 1/rate.
+        clock += -log(workload_uniform(&state)) / rate;
+        // Inverse-CDF sample of a Pareto(min_burst, alpha) burst.
+        double burst = min_burst / pow(workload_uniform(&state), 1.0 / alpha);
+        if (burst > WORKLOAD_MAX_BURST) burst = WORKLOAD_MAX_BURST;
+
+        recs[i].arrival_time = (clock < 0x7fffffff) ? (int)clock : 0x7fffffff;
+        recs[i].burst_time = (int)burst;
+        recs[i].nice = 0;
+    }
+    return recs;
+}
+
+#endif // WORKLOAD_H
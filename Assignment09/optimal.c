@@ -14,25 +14,19 @@
  * 2. If it's a hit, do nothing.
  * 3. If it's not in a frame (a "fault"):
  *    a. Find an empty frame. If one exists, place the new page there.
- *    b. If no frames are empty, look ahead in the reference string to find
- *       which page currently in a frame will be used furthest in the future
- *       (or not at all). Replace that page.
+ *    b. If no frames are empty, replace the page currently in a frame that
+ *       will be used furthest in the future (or not at all).
+ *
+ * Instead of looking ahead in the reference string on every fault, the next
+ * use of every reference is computed once in a forward pass (each reference
+ * fills in the next use of the page's previous reference), and resident
+ * pages are kept in a max-heap keyed on their next use (the OptCache in
+ * replacement.h). A fault then costs O(log frames).
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <limits.h> // Included for INT_MAX, though not used in this version.
-
-/**
- * @brief Helper to check if a page is in frames.
- * @return Index if found, -1 otherwise.
- */
-int find_page(int frames[], int n_frames, int page) {
-    for (int i = 0; i < n_frames; i++) {
-        if (frames[i] == page) return i;
-    }
-    return -1;
-}
+#include "replacement.h"
 
 /**
  * @brief Helper to print the current state of frames.
@@ -52,57 +46,26 @@ void print_frames(int frames[], int n_frames) {
  * @param n_frames The number of available frames in memory.
  */
 void run_optimal(int pages[], int n_pages, int n_frames) {
-    int *frames = (int*)calloc(n_frames, sizeof(int));
-    for(int i = 0; i < n_frames; i++) frames[i] = -1; // Initialize frames to empty
+    OptCache cache;
+    opt_init(&cache, pages, n_pages, n_frames);
 
     int page_faults = 0;
 
     printf("\n---=== [ Optimal Simulation ] ===---\n");
     for (int i = 0; i < n_pages; i++) {
+        int frame, victim;
         printf("Ref: %d", pages[i]);
-        if (find_page(frames, n_frames, pages[i]) == -1) { // --- Page Fault ---
+        if (opt_reference(&cache, pages[i], i, &frame, &victim)) { // --- Page Fault ---
             page_faults++;
-
-            // First, try to find an empty frame.
-            int empty_index = find_page(frames, n_frames, -1);
-            if (empty_index != -1) {
-                frames[empty_index] = pages[i];
-            } else {
-                // If no empty frames, find the optimal page to replace.
-                int replace_index = -1;
-                int farthest_use = -1;
-
-                for (int j = 0; j < n_frames; j++) {
-                    // Look ahead in the page reference string.
-                    int k;
-                    for (k = i + 1; k < n_pages; k++) {
-                        if (frames[j] == pages[k]) {
-                            // Found a future use. If it's farther than what we've seen, update.
-                            if (k > farthest_use) {
-                                farthest_use = k;
-                                replace_index = j;
-                            }
-                            break;
-                        }
-                    }
-                    // If the loop finished without a break, this page is never used again.
-                    // This is the best page to replace.
-                    if (k == n_pages) {
-                        replace_index = j;
-                        break; // Found the perfect victim, no need to check other frames.
-                    }
-                }
-                frames[replace_index] = pages[i];
-            }
-            print_frames(frames, n_frames);
+            print_frames(cache.frame_page, n_frames);
             printf("(Fault)\n");
         } else { // --- Page Hit ---
-            print_frames(frames, n_frames);
+            print_frames(cache.frame_page, n_frames);
             printf("(Hit)\n");
         }
     }
     printf("Total Page Faults (Optimal): %d\n", page_faults);
-    free(frames);
+    opt_free(&cache);
 }
 
 int main() {
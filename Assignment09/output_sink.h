@@ -0,0 +1,259 @@
+/*
+ * output_sink.h
+ * =============
+ * Where the page replacement simulators send their per-reference output.
+ *
+ * Formatting a line of frames for every reference costs far more than the
+ * simulation itself on a large trace, so the run_* loops report each event
+ * to an OutputSink, which decides what to do with it:
+ * - SINK_FULL:    the classic dump, "Ref: 3  Frames: [1] [3] [ ] (Fault)".
+ * - SINK_SUMMARY: nothing per reference; only the fault total.
+ * - SINK_SAMPLED: the classic line for every Nth reference only.
+ * - SINK_BINARY:  a fixed-size record per reference, written through a large
+ *                 buffer to an event log; totals still go to stdout.
+ *
+ * Event log layout (host byte order, little endian on x86):
+ *   per simulation, a 32-byte section header
+ *     char     magic[4]   "PGEV"
+ *     uint32   n_frames
+ *     uint64   n_events
+ *     char     name[16]   policy name, NUL padded
+ *   followed by n_events records of three uint32:
+ *     page, frame | SINK_FAULT_BIT on a fault, victim (SINK_NO_VICTIM if none)
+ * Replaying the records over an empty frame table rebuilds the full dump;
+ * sink_decode_events() does exactly that.
+ *
+ * Every function is static inline so each simulator can include this header
+ * directly and still be compiled on its own.
+ */
+
+#ifndef OUTPUT_SINK_H
+#define OUTPUT_SINK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define SINK_MAGIC "PGEV"
+#define SINK_HEADER_SIZE 32
+#define SINK_NAME_LEN 16
+#define SINK_RECORD_SIZE 12
+#define SINK_FAULT_BIT 0x80000000u
+#define SINK_NO_VICTIM 0xFFFFFFFFu
+#define SINK_BUFFER (1 << 20) // Event log buffer size in bytes
+
+typedef enum { SINK_FULL, SINK_SUMMARY, SINK_SAMPLED, SINK_BINARY } SinkMode;
+
+typedef struct {
+    SinkMode mode;
+    long every;           // SINK_SAMPLED: print references 1, every + 1, 2 * every + 1, ...
+    long step;            // References seen in the current simulation
+    FILE *fp;             // SINK_BINARY: the event log
+    unsigned char *buf;
+    size_t len;           // Bytes waiting in buf
+} OutputSink;
+
+/**
+ * @brief Prepares a sink; for SINK_BINARY, creates the event log at 'path'.
+ * @return 0 on success, -1 if the log cannot be created.
+ */
+static inline int sink_open(OutputSink* s, SinkMode mode, long every, const char* path) {
+    s->mode = mode;
+    s->every = (every > 0) ? every : 1;
+    s->step = 0;
+    s->fp = NULL;
+    s->buf = NULL;
+    s->len = 0;
+    if (mode == SINK_BINARY) {
+        s->fp = fopen(path, "wb");
+        if (s->fp == NULL) {
+            perror(path);
+            return -1;
+        }
+        s->buf = (unsigned char*)malloc(SINK_BUFFER);
+    }
+    return 0;
+}
+
+static inline void sink_flush(OutputSink* s) {
+    if (s->len > 0) fwrite(s->buf, 1, s->len, s->fp);
+    s->len = 0;
+}
+
+/**
+ * @brief Flushes and closes the event log, if any.
+ * @return 0 on success, -1 on a write error.
+ */
+static inline int sink_close(OutputSink* s) {
+    int status = 0;
+    if (s->fp != NULL) {
+        sink_flush(s);
+        if (ferror(s->fp)) status = -1;
+        if (fclose(s->fp) != 0) status = -1;
+        if (status != 0) perror("event log");
+    }
+    free(s->buf);
+    s->fp = NULL;
+    s->buf = NULL;
+    return status;
+}
+
+static inline void sink_put(OutputSink* s, const void* data, size_t size) {
+    if (s->len + size > SINK_BUFFER) sink_flush(s);
+    memcpy(s->buf + s->len, data, size);
+    s->len += size;
+}
+
+/**
+ * @brief Helper to print the current state of frames.
+ */
+static inline void sink_print_frames(const int frames[], int n_frames) {
+    printf("\tFrames: ");
+    for (int i = 0; i < n_frames; i++) {
+        if (frames[i] == -1) printf("[ ] "); // -1 represents an empty frame
+        else printf("[%d] ", frames[i]);
+    }
+}
+
+/**
+ * @brief Starts one simulation: prints its banner, or writes its section header.
+ * @param n_events Number of references that will follow.
+ */
+static inline void sink_begin(OutputSink* s, const char* name, int n_frames, uint64_t n_events) {
+    s->step = 0;
+    if (s->mode == SINK_BINARY) {
+        unsigned char header[SINK_HEADER_SIZE] = { 0 };
+        uint32_t frames = (uint32_t)n_frames;
+        memcpy(header, SINK_MAGIC, 4);
+        memcpy(header + 4, &frames, sizeof(frames));
+        memcpy(header + 8, &n_events, sizeof(n_events));
+        strncpy((char*)header + 16, name, SINK_NAME_LEN - 1);
+        sink_put(s, header, sizeof(header));
+        return;
+    }
+    printf("\n---=== [ %s Simulation ] ===---\n", name);
+}
+
+/**
+ * @brief Reports one reference.
+ * @param frame Frame holding the page after the reference.
+ * @param victim Page evicted by this reference, -1 if none.
+ * @param frames Frame table after the reference (printed in the text modes).
+ */
+static inline void sink_event(OutputSink* s, int page, int fault, int frame, int victim, const int frames[], int n_frames) {
+    long step = s->step++;
+    switch (s->mode) {
+    case SINK_SUMMARY:
+        return;
+    case SINK_BINARY: {
+        uint32_t record[3];
+        record[0] = (uint32_t)page;
+        record[1] = (uint32_t)frame | (fault ? SINK_FAULT_BIT : 0);
+        record[2] = (victim == -1) ? SINK_NO_VICTIM : (uint32_t)victim;
+        sink_put(s, record, sizeof(record));
+        return;
+    }
+    case SINK_SAMPLED:
+        if (step % s->every != 0) return;
+        printf("[%ld] ", step + 1);
+        break;
+    default:
+        break;
+    }
+    printf("Ref: %d", page);
+    sink_print_frames(frames, n_frames);
+    printf(fault ? "(Fault)\n" : "(Hit)\n");
+}
+
+/**
+ * @brief Ends one simulation with its fault total (printed in every mode).
+ */
+static inline void sink_end(OutputSink* s, const char* name, int faults) {
+    (void)s;
+    printf("Total Page Faults (%s): %d\n", name, faults);
+}
+
+/**
+ * @brief Rebuilds the full per-reference dump from an event log.
+ * @return 0 on success, -1 if the file is missing or malformed.
+ */
+static inline int sink_decode_events(const char* path) {
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    const unsigned char* data = (const unsigned char*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    madvise((void*)data, st.st_size, MADV_SEQUENTIAL);
+
+    const unsigned char* p = data;
+    const unsigned char* end = data + st.st_size;
+    int status = 0;
+    OutputSink out;
+    sink_open(&out, SINK_FULL, 1, NULL);
+
+    while (p < end) {
+        uint32_t n_frames;
+        uint64_t n_events;
+        char name[SINK_NAME_LEN + 1] = { 0 };
+        if (end - p < SINK_HEADER_SIZE || memcmp(p, SINK_MAGIC, 4) != 0) {
+            status = -1;
+            break;
+        }
+        memcpy(&n_frames, p + 4, sizeof(n_frames));
+        memcpy(&n_events, p + 8, sizeof(n_events));
+        memcpy(name, p + 16, SINK_NAME_LEN);
+        p += SINK_HEADER_SIZE;
+        if (n_frames == 0 || n_frames > 0x7fffffff ||
+            n_events > (uint64_t)(end - p) / SINK_RECORD_SIZE) {
+            status = -1;
+            break;
+        }
+
+        int* frames = (int*)malloc(n_frames * sizeof(int));
+        int faults = 0;
+        for (uint32_t f = 0; f < n_frames; f++) frames[f] = -1;
+        sink_begin(&out, name, (int)n_frames, n_events);
+        for (uint64_t e = 0; e < n_events; e++, p += SINK_RECORD_SIZE) {
+            uint32_t record[3];
+            memcpy(record, p, sizeof(record));
+            int fault = (record[1] & SINK_FAULT_BIT) != 0;
+            uint32_t frame = record[1] & ~SINK_FAULT_BIT;
+            if (frame >= n_frames) {
+                status = -1;
+                break;
+            }
+            if (fault) {
+                frames[frame] = (int)record[0];
+                faults++;
+            }
+            sink_event(&out, (int)record[0], fault, (int)frame,
+                       record[2] == SINK_NO_VICTIM ? -1 : (int)record[2], frames, (int)n_frames);
+        }
+        free(frames);
+        if (status != 0) break;
+        sink_end(&out, name, faults);
+    }
+
+    if (status != 0) fprintf(stderr, "%s: corrupt event log\n", path);
+    munmap((void*)data, st.st_size);
+    return status;
+}
+
+#endif // OUTPUT_SINK_H
@@ -0,0 +1,149 @@
+/*
+ * page_map.h
+ * ==========
+ * Hash table from page number to a small non-negative integer (a frame index,
+ * a list node, a reference position, ...) used by the page replacement
+ * simulators, so that "is this page resident, and where?" is O(1) instead of
+ * a scan over every frame.
+ *
+ * Open addressing with linear probing over a power-of-two table kept at most
+ * half full; deletion shifts later entries of the probe run back instead of
+ * leaving tombstones, so lookups never slow down as pages come and go.
+ *
+ * Every function is static inline so each simulator can include this header
+ * directly and still be compiled on its own (gcc lru.c).
+ */
+
+#ifndef PAGE_MAP_H
+#define PAGE_MAP_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+typedef struct {
+    uint64_t *keys;
+    int *values;
+    unsigned char *used;  // 1 if the slot holds an entry
+    size_t capacity;      // Always a power of two
+    size_t size;
+} PageMap;
+
+/**
+ * @brief Mixes the bits of a page number (splitmix64 finalizer) so that
+ *        sequential pages spread over the whole table.
+ */
+static inline size_t page_map_hash(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBULL;
+    key ^= key >> 31;
+    return (size_t)key;
+}
+
+/**
+ * @brief Allocates an empty map sized for about 'expected' entries.
+ */
+static inline void page_map_init(PageMap* m, size_t expected) {
+    size_t capacity = 16;
+    while (capacity < 2 * expected) capacity *= 2;
+    m->keys = (uint64_t*)malloc(capacity * sizeof(uint64_t));
+    m->values = (int*)malloc(capacity * sizeof(int));
+    m->used = (unsigned char*)calloc(capacity, 1);
+    m->capacity = capacity;
+    m->size = 0;
+}
+
+static inline void page_map_free(PageMap* m) {
+    free(m->keys);
+    free(m->values);
+    free(m->used);
+}
+
+/**
+ * @brief Removes every entry but keeps the table allocated.
+ */
+static inline void page_map_clear(PageMap* m) {
+    for (size_t i = 0; i < m->capacity; i++) m->used[i] = 0;
+    m->size = 0;
+}
+
+/**
+ * @brief Bytes allocated for the table (keys, values and occupancy flags).
+ */
+static inline size_t page_map_bytes(const PageMap* m) {
+    return m->capacity * (sizeof(uint64_t) + sizeof(int) + 1);
+}
+
+/**
+ * @brief Slot holding 'key', or the empty slot where it would be inserted.
+ */
+static inline size_t page_map_slot(const PageMap* m, uint64_t key) {
+    size_t mask = m->capacity - 1;
+    size_t i = page_map_hash(key) & mask;
+    while (m->used[i] && m->keys[i] != key) i = (i + 1) & mask;
+    return i;
+}
+
+/**
+ * @brief Value stored for 'key', or -1 if the key is absent.
+ */
+static inline int page_map_get(const PageMap* m, uint64_t key) {
+    size_t i = page_map_slot(m, key);
+    return m->used[i] ? m->values[i] : -1;
+}
+
+static inline void page_map_put(PageMap* m, uint64_t key, int value);
+
+// Doubles the table and reinserts every entry.
+static inline void page_map_grow(PageMap* m) {
+    PageMap old = *m;
+    page_map_init(m, old.capacity);
+    for (size_t i = 0; i < old.capacity; i++) {
+        if (old.used[i]) page_map_put(m, old.keys[i], old.values[i]);
+    }
+    page_map_free(&old);
+}
+
+/**
+ * @brief Inserts 'key' or overwrites its value.
+ */
+static inline void page_map_put(PageMap* m, uint64_t key, int value) {
+    size_t i = page_map_slot(m, key);
+    if (!m->used[i]) {
+        if (2 * (m->size + 1) > m->capacity) {
+            page_map_grow(m);
+            i = page_map_slot(m, key);
+        }
+        m->used[i] = 1;
+        m->keys[i] = key;
+        m->size++;
+    }
+    m->values[i] = value;
+}
+
+/**
+ * @brief Deletes 'key' if present (backward-shift deletion, no tombstones).
+ */
+static inline void page_map_remove(PageMap* m, uint64_t key) {
+    size_t mask = m->capacity - 1;
+    size_t hole = page_map_slot(m, key);
+    if (!m->used[hole]) return;
+
+    // Pull back any later entry of the probe run whose home slot is at or before the hole.
+    size_t j = hole;
+    while (1) {
+        j = (j + 1) & mask;
+        if (!m->used[j]) break;
+        size_t home = page_map_hash(m->keys[j]) & mask;
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            m->keys[hole] = m->keys[j];
+            m->values[hole] = m->values[j];
+            hole = j;
+        }
+    }
+    m->used[hole] = 0;
+    m->size--;
+}
+
+#endif // PAGE_MAP_H
@@ -4,33 +4,309 @@
  * This program implements three different page replacement algorithms used in operating systems:
  * 1. FIFO (First-In-First-Out): Replaces the oldest page in memory
  * 2. LRU (Least Recently Used): Replaces the page that hasn't been used for the longest time
+ *    (O(1) per reference: hash map plus recency list, see replacement.h)
  * 3. Optimal: Replaces the page that won't be used for the longest time in the future
+ *    (O(log frames) per fault: precomputed next uses plus a max-heap)
+ * 4. CLOCK (second chance): FIFO that skips pages used since the hand last passed
+ * 5. ARC: balances recency and frequency lists, tuned by hits on recently evicted pages
+ * 6. 2Q: pages must be used twice before joining the main LRU list
+ * 7. LIRS: ranks pages by reuse distance instead of recency
+ *    (4-7 are O(1) amortized per reference, see replacement.h)
  *
  * The program allows users to:
- * - Specify the number of page frames (minimum 3)
+ * - Specify the number of page frames (minimum 1)
  * - Input a sequence of page references
  * - View the simulation of each algorithm
- * - Compare their performance based on page faults
+ * - Compare their performance based on page faults, hit rate and the memory
+ *   each policy spends on bookkeeping (hits per KB of metadata)
+ *
+ * Miss-ratio curve mode:
+ *   ./page_replacement --mrc [MAX_FRAMES] < refs.txt
+ * reads the number of references and the reference string from stdin
+ * (without prompts) and prints the LRU fault count for every frame count
+ * from 1 to MAX_FRAMES (default: the number of distinct pages) as CSV. All
+ * sizes come from one pass of Mattson's stack algorithm, O(log n) per
+ * reference, instead of one simulation per frame count.
+ *
+ * Sampled miss-ratio curve mode:
+ *   ./page_replacement --shards SAMPLE_PAGES MAX_FRAMES [--check] < refs.txt
+ * estimates the same curve while tracking at most SAMPLE_PAGES hash-sampled
+ * pages (fixed-size SHARDS), so memory stays fixed however long the trace
+ * is. --check also runs the exact pass and reports the error per size.
+ *
+ * Policy comparison mode:
+ *   ./page_replacement --compare FRAMES < refs.txt
+ * runs every policy on the same reference string without the per-reference
+ * trace and prints only the comparison table.
+ *
+ * Trace replay:
+ *   ./page_replacement --trace FILE [FRAMES | --compare FRAMES | --mrc ... | --shards ...]
+ * takes the references from a trace written by trace_ingest instead of
+ * stdin. The file is mmap'ed and decoded one reference at a time by every
+ * algorithm, so it is never loaded into memory as a whole; pages appear as
+ * the dense ids trace_ingest assigned. With just FRAMES, every simulation
+ * runs with its per-reference output.
+ *
+ * Parallel replay mode:
+ *   ./page_replacement [--trace FILE] --replay FRAME_LIST [--threads T] [< refs.txt]
+ * runs every policy at every frame count in FRAME_LIST (e.g. 64,128,256-1024:256)
+ * as independent jobs on a pool of T threads (default: one per online CPU).
+ * All workers decode the same read-only trace (or array) through their own
+ * cursor, OPT's next-use array is computed once and shared, and the fault
+ * counts are merged into one table.
+ *
+ * Address translation mode:
+ *   ./page_replacement [--trace FILE] --tlb FRAMES [SETS WAYS] [< refs.txt]
+ * puts a set-associative TLB (default 16 sets x 4 ways) and a 4-level radix
+ * page table (tlb_sim.h) in front of FIFO, LRU and OPT, with FRAMES 4KB
+ * frames of memory, and reports TLB miss rate, page walk memory references
+ * and faults. It runs once with 4KB pages and once with 2MB huge pages in the
+ * same memory (FRAMES / 512 huge frames), to show whether huge pages help.
+ * Trace files supply the original page numbers; typed-in pages are taken as
+ * 4KB virtual page numbers.
+ *
+ * Multiprogramming mode:
+ *   ./page_replacement --multi FRAMES [WINDOW] < pid_refs.txt
+ * reads the number of references, then that many "PID page" pairs from
+ * several processes interleaved, and shares FRAMES frames among them with
+ * global LRU replacement and with local LRU replacement under fixed,
+ * proportional (to each process's distinct pages), working-set (window of
+ * WINDOW references, default 100) and page-fault-frequency allocation. It
+ * prints total and per-process fault rates, how often the system thrashed
+ * and how often the allocations added up to more than memory. Every
+ * reference is O(1) (PartitionCache and WorkingSet in replacement.h).
+ * pff_refusals.txt is a small reference case: with --multi 4 2, PFF refuses
+ * PID 1 a frame from its first fault until another frame frees up at
+ * reference 7, so PFF reports 6.00% overcommitted and the others 0.00%.
+ *
+ * Output options (for the per-reference simulations, in any position;
+ * the table-only modes above reject them):
+ *   --summary        print only the fault totals and the comparison table
+ *   --every N        print only every Nth reference (numbered)
+ *   --events FILE    write one 12-byte record per reference (page, frame,
+ *                    hit/fault, victim) to FILE instead of printing it
+ *   --decode-events FILE
+ *                    rebuild the full per-reference output from such a file
+ * See output_sink.h for the event log layout.
+ *
+ * Compile with: gcc page_replacement.c -o page_replacement -pthread
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <limits.h> // For INT_MAX in optimal algorithm
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h> // For sysconf() to size the thread pool
+#include "replacement.h" // Indexed replacement engines (O(1) LRU, heap-based OPT)
+#include "output_sink.h" // Per-reference output: full, summary, sampled or binary
+#include "tlb_sim.h" // TLB and 4-level page table in front of the frame policies
+
+/* Policies that can be replayed without tracing */
+typedef enum { POLICY_FIFO, POLICY_LRU, POLICY_OPT, POLICY_CLOCK, POLICY_ARC, POLICY_2Q, POLICY_LIRS, N_POLICIES } Policy;
+
+const char* const policy_names[N_POLICIES] = { "FIFO", "LRU", "Optimal", "CLOCK", "ARC", "2Q", "LIRS" };
+
+/* One (policy, frame count) run of a parallel replay and its result */
+typedef struct {
+    Policy policy;
+    int n_frames;
+    int faults;
+} ReplayJob;
+
+/* Address translation cost of one policy behind the TLB and page table */
+typedef struct {
+    long long tlb_misses;
+    long long walk_refs;   // Page table entries read by walks
+    int faults;
+    int table_nodes;       // Page table pages allocated
+} TranslationStats;
+
+/* Frame allocation strategies for processes sharing memory */
+typedef enum { ALLOC_GLOBAL, ALLOC_FIXED, ALLOC_PROPORTIONAL, ALLOC_WORKING_SET, ALLOC_PFF, N_ALLOCATIONS } Allocation;
+
+const char* const allocation_names[N_ALLOCATIONS] = { "Global LRU", "Fixed", "Proportional", "Working set", "PFF" };
+
+/* Interleaved references of several processes, renumbered densely */
+typedef struct {
+    int n_refs;
+    int n_procs;
+    int n_pages;      // Distinct (process, page) pairs
+    int *proc;        // Process index of each reference
+    int *page;        // Page id of each reference, unique across processes
+    int *pids;        // Process index -> PID
+    int *proc_refs;   // References per process
+    int *proc_pages;  // Distinct pages per process
+} MultiTrace;
+
+#define THRASH_EPOCH 1000     // References per thrashing check
+#define THRASH_FAULT_RATE 0.5 // An epoch faulting more often than this is thrashing
+#define DEFAULT_WS_WINDOW 100 // Working set window and PFF interval, in a process's references
+
+#define TLB_BASE_PAGE_SHIFT 12 // Page table walks are over 4KB virtual page numbers
+#define TLB_DEFAULT_SETS 16
+#define TLB_DEFAULT_WAYS 4
+
+/* State shared by all replay workers */
+typedef struct {
+    const RefTrace *trace; // Read-only input shared by every worker
+    int *next_use;         // OPT next uses, computed once for all OPT jobs
+    ReplayJob *jobs;
+    int n_jobs;
+    int next_job;          // Next unclaimed job, taken with an atomic add
+} ReplayContext;
 
 // --- Function Prototypes ---
-void run_fifo(int pages[], int n_pages, int n_frames);
-void run_lru(int pages[], int n_pages, int n_frames);
-void run_optimal(int pages[], int n_pages, int n_frames);
+void run_fifo(RefTrace* refs, int n_frames, OutputSink* out);
+void run_lru(RefTrace* refs, int n_frames, OutputSink* out);
+void run_optimal(RefTrace* refs, int n_frames, OutputSink* out);
+void run_clock(RefTrace* refs, int n_frames, OutputSink* out);
+void run_arc(RefTrace* refs, int n_frames, OutputSink* out);
+void run_2q(RefTrace* refs, int n_frames, OutputSink* out);
+void run_lirs(RefTrace* refs, int n_frames, OutputSink* out);
+void run_all(RefTrace* refs, int n_frames, OutputSink* out);
+void run_comparison(RefTrace* refs, int n_frames);
+int replay_policy(Policy policy, RefTrace* refs, int n_frames, const int next_use[], size_t* metadata);
+void* replay_worker(void* arg);
+void run_replay(RefTrace* refs, const int frames[], int n_sizes, int threads);
+int* parse_frame_list(const char* list, int* n_sizes);
+int compare_int(const void* a, const void* b);
+uint64_t virtual_page(const RefTrace* refs, int page);
+TranslationStats replay_translated(Policy policy, RefTrace* refs, int huge, int n_frames,
+                                   int sets, int ways, const int next_use[]);
+void run_tlb(RefTrace* refs, int n_frames, int sets, int ways);
+int read_multi_trace(MultiTrace* mt);
+void multi_trace_free(MultiTrace* mt);
+int simulate_allocation(Allocation strategy, const MultiTrace* mt, int n_frames, int window,
+                        int proc_faults[], double* thrashing, double* overcommitted);
+void run_multiprogramming(const MultiTrace* mt, int n_frames, int window);
+void run_mrc(RefTrace* refs, int max_frames);
+void run_shards(RefTrace* refs, int sample_pages, int max_frames, int check);
+int open_references(const char* trace_path, RefTrace* refs, int** pages);
+int* read_reference_string(int* n_pages);
 int find_page(int frames[], int n_frames, int page);
-void print_frames(int frames[], int n_frames);
 
-int main() {
+int main(int argc, char* argv[]) {
     int n_frames, n_pages;
+    int *pages = NULL;
+    const char *prog = argv[0], *trace_path = NULL, *events_path = NULL;
+    SinkMode sink_mode = SINK_FULL;
+    long every = 1;
+    OutputSink out;
+    RefTrace refs;
+
+    // Output options may appear anywhere; strip them so the mode parsing below sees the rest.
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--summary") == 0) {
+            sink_mode = SINK_SUMMARY;
+        } else if (strcmp(argv[i], "--every") == 0 && i + 1 < argc) {
+            sink_mode = SINK_SAMPLED;
+            every = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            sink_mode = SINK_BINARY;
+            events_path = argv[++i];
+        } else if (strcmp(argv[i], "--decode-events") == 0 && i + 1 < argc) {
+            return sink_decode_events(argv[i + 1]) == 0 ? 0 : 1;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    argc = kept;
+    argv[argc] = NULL;
+
+    if (argc > 2 && strcmp(argv[1], "--trace") == 0) {
+        trace_path = argv[2];
+        argc -= 2;
+        argv += 2;
+        if (argc > 1 && argv[1][0] != '-') {
+            n_frames = atoi(argv[1]);
+            if (n_frames < 1 || open_references(trace_path, &refs, &pages) != 0) return 1;
+            if (sink_open(&out, sink_mode, every, events_path) != 0) {
+                ref_trace_close(&refs);
+                return 1;
+            }
+            run_all(&refs, n_frames, &out);
+            ref_trace_close(&refs);
+            return sink_close(&out) == 0 ? 0 : 1;
+        }
+    }
+
+    // The sink only carries the per-reference output of run_all; the other modes print tables.
+    if (argc > 1 && sink_mode != SINK_FULL) {
+        fprintf(stderr, "--summary, --every and --events only apply to the per-reference simulations.\n");
+        return 1;
+    }
 
-    printf("Enter the number of frames (minimum 3): ");
+    if (argc > 1 && strcmp(argv[1], "--mrc") == 0) {
+        int max_frames = (argc > 2) ? atoi(argv[2]) : 0;
+        if (max_frames < 0 || open_references(trace_path, &refs, &pages) != 0) return 1;
+        run_mrc(&refs, max_frames);
+        ref_trace_close(&refs);
+        free(pages);
+        return 0;
+    }
+    if (argc > 3 && strcmp(argv[1], "--shards") == 0) {
+        int sample_pages = atoi(argv[2]);
+        int max_frames = atoi(argv[3]);
+        int check = (argc > 4 && strcmp(argv[4], "--check") == 0);
+        if (sample_pages <= 0 || max_frames <= 0 || open_references(trace_path, &refs, &pages) != 0) return 1;
+        run_shards(&refs, sample_pages, max_frames, check);
+        ref_trace_close(&refs);
+        free(pages);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--compare") == 0) {
+        n_frames = atoi(argv[2]);
+        if (n_frames < 1 || open_references(trace_path, &refs, &pages) != 0) return 1;
+        run_comparison(&refs, n_frames);
+        ref_trace_close(&refs);
+        free(pages);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--replay") == 0) {
+        int n_sizes, threads = 0;
+        if (argc > 4 && strcmp(argv[3], "--threads") == 0) threads = atoi(argv[4]);
+        int *frames = parse_frame_list(argv[2], &n_sizes);
+        if (frames == NULL || open_references(trace_path, &refs, &pages) != 0) return 1;
+        run_replay(&refs, frames, n_sizes, threads);
+        ref_trace_close(&refs);
+        free(frames);
+        free(pages);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--tlb") == 0) {
+        int sets = (argc > 4) ? atoi(argv[3]) : TLB_DEFAULT_SETS;
+        int ways = (argc > 4) ? atoi(argv[4]) : TLB_DEFAULT_WAYS;
+        n_frames = atoi(argv[2]);
+        if (n_frames < 1 || sets < 1 || ways < 1 || open_references(trace_path, &refs, &pages) != 0) return 1;
+        run_tlb(&refs, n_frames, sets, ways);
+        ref_trace_close(&refs);
+        free(pages);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--multi") == 0 && trace_path == NULL) {
+        MultiTrace mt;
+        int window = (argc > 3) ? atoi(argv[3]) : DEFAULT_WS_WINDOW;
+        n_frames = atoi(argv[2]);
+        if (n_frames < 1 || window < 1 || read_multi_trace(&mt) != 0) return 1;
+        if (n_frames < mt.n_procs) {
+            fprintf(stderr, "Need at least one frame per process (%d processes).\n", mt.n_procs);
+            multi_trace_free(&mt);
+            return 1;
+        }
+        run_multiprogramming(&mt, n_frames, window);
+        multi_trace_free(&mt);
+        return 0;
+    }
+    if (trace_path != NULL) {
+        fprintf(stderr, "Usage: %s --trace FILE [FRAMES | --compare FRAMES | --mrc [MAX_FRAMES] | --shards SAMPLE_PAGES MAX_FRAMES [--check] | --replay FRAME_LIST [--threads T] | --tlb FRAMES [SETS WAYS]]\n", prog);
+        return 1;
+    }
+
+    printf("Enter the number of frames (minimum 1): ");
     scanf("%d", &n_frames);
-    if (n_frames < 3) {
-        printf("Frame size must be at least 3.\n");
+    if (n_frames < 1) {
+        printf("Frame size must be at least 1.\n");
         return 1;
     }
 
@@ -38,170 +314,898 @@ int main() {
     scanf("%d", &n_pages);
     if (n_pages <= 0) return 1;
 
-    int *pages = (int*)malloc(n_pages * sizeof(int));
+    pages = (int*)malloc(n_pages * sizeof(int));
     printf("Enter the page reference string:\n");
     for (int i = 0; i < n_pages; i++) {
         scanf("%d", &pages[i]);
     }
 
     // Run simulations
-    run_fifo(pages, n_pages, n_frames);
-    run_lru(pages, n_pages, n_frames);
-    run_optimal(pages, n_pages, n_frames);
+    if (sink_open(&out, sink_mode, every, events_path) != 0) {
+        free(pages);
+        return 1;
+    }
+    ref_trace_from_array(&refs, pages, n_pages);
+    run_all(&refs, n_frames, &out);
 
     free(pages);
+    return sink_close(&out) == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Runs every simulation with its per-reference output, then the comparison table.
+ */
+void run_all(RefTrace* refs, int n_frames, OutputSink* out) {
+    run_fifo(refs, n_frames, out);
+    run_lru(refs, n_frames, out);
+    run_optimal(refs, n_frames, out);
+    run_clock(refs, n_frames, out);
+    run_arc(refs, n_frames, out);
+    run_2q(refs, n_frames, out);
+    run_lirs(refs, n_frames, out);
+    run_comparison(refs, n_frames);
+}
+
+/**
+ * @brief Opens the references for a non-interactive mode: the mmap'ed trace
+ *        file if one was given, otherwise a reference string read from stdin.
+ * @param pages Receives the array read from stdin (NULL for a trace file), to free afterwards.
+ * @return 0 on success, -1 on error.
+ */
+int open_references(const char* trace_path, RefTrace* refs, int** pages) {
+    int n_pages;
+    if (trace_path != NULL) {
+        if (ref_trace_open(refs, trace_path) != 0) return -1;
+        if (refs->count == 0) {
+            fprintf(stderr, "%s: empty trace\n", trace_path);
+            ref_trace_close(refs);
+            return -1;
+        }
+        return 0;
+    }
+    *pages = read_reference_string(&n_pages);
+    if (*pages == NULL) return -1;
+    ref_trace_from_array(refs, *pages, n_pages);
     return 0;
 }
 
 /**
- * @brief Helper to check if a page is in a frame.
- * @return Index if found, -1 otherwise.
+ * @brief Reads "count, then that many page numbers" from stdin without prompts.
+ * @return Newly allocated reference string, or NULL on bad input.
  */
-int find_page(int frames[], int n_frames, int page) {
-    for (int i = 0; i < n_frames; i++) {
-        if (frames[i] == page) return i;
+int* read_reference_string(int* n_pages) {
+    if (scanf("%d", n_pages) != 1 || *n_pages <= 0) return NULL;
+    int *pages = (int*)malloc(*n_pages * sizeof(int));
+    for (int i = 0; i < *n_pages; i++) {
+        if (scanf("%d", &pages[i]) != 1) {
+            fprintf(stderr, "Expected %d page references, got %d.\n", *n_pages, i);
+            free(pages);
+            return NULL;
+        }
     }
-    return -1;
+    return pages;
 }
 
 /**
- * @brief Helper to print the current state of frames.
+ * @brief Helper to check if a page is in a frame.
+ * @return Index if found, -1 otherwise.
  */
-void print_frames(int frames[], int n_frames) {
-    printf("\tFrames: ");
+int find_page(int frames[], int n_frames, int page) {
     for (int i = 0; i < n_frames; i++) {
-        if (frames[i] == -1) printf("[ ] ");
-        else printf("[%d] ", frames[i]);
+        if (frames[i] == page) return i;
     }
+    return -1;
 }
 
 /**
  * @brief Simulates First-In, First-Out (FIFO)
  */
-void run_fifo(int pages[], int n_pages, int n_frames) {
+void run_fifo(RefTrace* refs, int n_frames, OutputSink* out) {
     int *frames = (int*)calloc(n_frames, sizeof(int));
     for(int i = 0; i < n_frames; i++) frames[i] = -1; // -1 indicates empty
     
     int page_faults = 0;
     int victim_index = 0; // Tracks the oldest page
 
-    printf("\n---=== [ FIFO Simulation ] ===---\n");
-    for (int i = 0; i < n_pages; i++) {
-        printf("Ref: %d", pages[i]);
-        if (find_page(frames, n_frames, pages[i]) == -1) { // Page Fault
+    sink_begin(out, "FIFO", n_frames, refs->count);
+    int page;
+    ref_trace_rewind(refs);
+    while (ref_trace_next(refs, &page)) {
+        int frame = find_page(frames, n_frames, page);
+        if (frame == -1) { // Page Fault
             page_faults++;
-            frames[victim_index] = pages[i];
+            int victim = frames[victim_index];
+            frame = victim_index;
+            frames[victim_index] = page;
             victim_index = (victim_index + 1) % n_frames;
-            print_frames(frames, n_frames);
-            printf("(Fault)\n");
+            sink_event(out, page, 1, frame, victim, frames, n_frames);
         } else {
-            print_frames(frames, n_frames);
-            printf("(Hit)\n");
+            sink_event(out, page, 0, frame, -1, frames, n_frames);
         }
     }
-    printf("Total Page Faults (FIFO): %d\n", page_faults);
+    sink_end(out, "FIFO", page_faults);
     free(frames);
 }
 
 /**
  * @brief Simulates Least Recently Used (LRU)
+ *
+ * Resident pages are found through a page -> frame hash map and ordered by a
+ * doubly linked recency list (see replacement.h), so each reference costs
+ * O(1) however many frames there are.
  */
-void run_lru(int pages[], int n_pages, int n_frames) {
-    int *frames = (int*)calloc(n_frames, sizeof(int));
-    int *time_since_use = (int*)calloc(n_frames, sizeof(int)); // Counter
-    for(int i = 0; i < n_frames; i++) frames[i] = -1;
+void run_lru(RefTrace* refs, int n_frames, OutputSink* out) {
+    LruCache cache;
+    lru_init(&cache, n_frames);
 
     int page_faults = 0;
 
-    printf("\n---=== [ LRU Simulation ] ===---\n");
-    for (int i = 0; i < n_pages; i++) {
-        printf("Ref: %d", pages[i]);
-        int found_index = find_page(frames, n_frames, pages[i]);
+    sink_begin(out, "LRU", n_frames, refs->count);
+    int page;
+    ref_trace_rewind(refs);
+    while (ref_trace_next(refs, &page)) {
+        int frame, victim;
+        int fault = lru_reference(&cache, page, &frame, &victim);
+        page_faults += fault;
+        sink_event(out, page, fault, frame, victim, cache.frame_page, n_frames);
+    }
+    sink_end(out, "LRU", page_faults);
+    lru_free(&cache);
+}
 
-        if (found_index == -1) { // Page Fault
-            page_faults++;
-            // Find the LRU page (one with the largest time_since_use)
-            int lru_index = 0;
-            for (int j = 1; j < n_frames; j++) {
-                if (frames[j] == -1) { // Found an empty slot
-                    lru_index = j;
-                    break;
-                }
-                if (time_since_use[j] > time_since_use[lru_index]) {
-                    lru_index = j;
-                }
+/**
+ * @brief Simulates Optimal (OPT)
+ *
+ * Next uses are precomputed in one forward pass and resident pages are kept
+ * in a max-heap on their next use (see replacement.h), so a fault costs
+ * O(log frames) instead of a scan of the future reference string.
+ */
+void run_optimal(RefTrace* refs, int n_frames, OutputSink* out) {
+    OptCache cache;
+    opt_init_trace(&cache, refs, n_frames);
+
+    int page_faults = 0;
+
+    sink_begin(out, "Optimal", n_frames, refs->count);
+    int page;
+    ref_trace_rewind(refs);
+    for (int i = 0; ref_trace_next(refs, &page); i++) {
+        int frame, victim;
+        int fault = opt_reference(&cache, page, i, &frame, &victim);
+        page_faults += fault;
+        sink_event(out, page, fault, frame, victim, cache.frame_page, n_frames);
+    }
+    sink_end(out, "Optimal", page_faults);
+    opt_free(&cache);
+}
+
+/**
+ * @brief Simulates CLOCK (second chance)
+ *
+ * Each frame has a reference bit set on every use. On a fault the hand
+ * clears set bits as it sweeps and evicts the first page whose bit was
+ * already clear: an approximation of LRU with one bit per frame.
+ */
+void run_clock(RefTrace* refs, int n_frames, OutputSink* out) {
+    ClockCache cache;
+    clock_init(&cache, n_frames);
+
+    int page_faults = 0;
+
+    sink_begin(out, "CLOCK", n_frames, refs->count);
+    int page;
+    ref_trace_rewind(refs);
+    while (ref_trace_next(refs, &page)) {
+        int frame, victim;
+        int fault = clock_reference(&cache, page, &frame, &victim);
+        page_faults += fault;
+        sink_event(out, page, fault, frame, victim, cache.frame_page, n_frames);
+    }
+    sink_end(out, "CLOCK", page_faults);
+    clock_free(&cache);
+}
+
+/**
+ * @brief Simulates ARC (Adaptive Replacement Cache)
+ *
+ * Resident pages are split between a "seen once" and a "seen twice" LRU list;
+ * ghost lists of recently evicted pages decide how many frames each gets.
+ */
+void run_arc(RefTrace* refs, int n_frames, OutputSink* out) {
+    ArcCache cache;
+    arc_init(&cache, n_frames);
+
+    int page_faults = 0;
+
+    sink_begin(out, "ARC", n_frames, refs->count);
+    int page;
+    ref_trace_rewind(refs);
+    while (ref_trace_next(refs, &page)) {
+        int frame, victim;
+        int fault = arc_reference(&cache, page, &frame, &victim);
+        page_faults += fault;
+        sink_event(out, page, fault, frame, victim, cache.frame_page, n_frames);
+    }
+    sink_end(out, "ARC", page_faults);
+    arc_free(&cache);
+}
+
+/**
+ * @brief Simulates 2Q
+ *
+ * New pages go through a small FIFO (A1in); only pages used again soon after
+ * leaving it (while remembered in A1out) join the main LRU list (Am).
+ */
+void run_2q(RefTrace* refs, int n_frames, OutputSink* out) {
+    TwoQCache cache;
+    twoq_init(&cache, n_frames);
+
+    int page_faults = 0;
+
+    sink_begin(out, "2Q", n_frames, refs->count);
+    int page;
+    ref_trace_rewind(refs);
+    while (ref_trace_next(refs, &page)) {
+        int frame, victim;
+        int fault = twoq_reference(&cache, page, &frame, &victim);
+        page_faults += fault;
+        sink_event(out, page, fault, frame, victim, cache.frame_page, n_frames);
+    }
+    sink_end(out, "2Q", page_faults);
+    twoq_free(&cache);
+}
+
+/**
+ * @brief Simulates LIRS (Low Inter-reference Recency Set)
+ *
+ * Pages reused at short distances (LIR) keep about 99% of the frames; the
+ * rest cycle through a small FIFO of high-IRR (HIR) pages, so pages used
+ * once never displace the LIR set.
+ */
+void run_lirs(RefTrace* refs, int n_frames, OutputSink* out) {
+    LirsCache cache;
+    lirs_init(&cache, n_frames);
+
+    int page_faults = 0;
+
+    sink_begin(out, "LIRS", n_frames, refs->count);
+    int page;
+    ref_trace_rewind(refs);
+    while (ref_trace_next(refs, &page)) {
+        int frame, victim;
+        int fault = lirs_reference(&cache, page, &frame, &victim);
+        page_faults += fault;
+        sink_event(out, page, fault, frame, victim, cache.frame_page, n_frames);
+    }
+    sink_end(out, "LIRS", page_faults);
+    lirs_free(&cache);
+}
+
+/**
+ * @brief Replays the whole trace through one policy without tracing.
+ * @param next_use Next uses from opt_next_uses() for POLICY_OPT, shared
+ *        read-only between runs; NULL to compute them here.
+ * @param metadata Receives the bookkeeping bytes the policy allocated beyond
+ *        the frame table itself (may be NULL).
+ * @return Number of page faults.
+ */
+int replay_policy(Policy policy, RefTrace* refs, int n_frames, const int next_use[], size_t* metadata) {
+    int faults = 0, page, frame, victim;
+    size_t bytes = 0;
+
+    ref_trace_rewind(refs);
+    switch (policy) {
+    case POLICY_FIFO: {
+        FifoCache cache;
+        fifo_init(&cache, n_frames);
+        while (ref_trace_next(refs, &page)) faults += fifo_reference(&cache, page, &frame, &victim);
+        bytes = fifo_metadata_bytes(&cache);
+        fifo_free(&cache);
+        break;
+    }
+    case POLICY_LRU: {
+        LruCache cache;
+        lru_init(&cache, n_frames);
+        while (ref_trace_next(refs, &page)) faults += lru_reference(&cache, page, &frame, &victim);
+        bytes = lru_metadata_bytes(&cache);
+        lru_free(&cache);
+        break;
+    }
+    case POLICY_OPT: {
+        OptCache cache;
+        if (next_use != NULL) opt_init_shared(&cache, next_use, (int)refs->count, n_frames);
+        else opt_init_trace(&cache, refs, n_frames);
+        for (int i = 0; ref_trace_next(refs, &page); i++) faults += opt_reference(&cache, page, i, &frame, &victim);
+        bytes = opt_metadata_bytes(&cache);
+        opt_free(&cache);
+        break;
+    }
+    case POLICY_CLOCK: {
+        ClockCache cache;
+        clock_init(&cache, n_frames);
+        while (ref_trace_next(refs, &page)) faults += clock_reference(&cache, page, &frame, &victim);
+        bytes = clock_metadata_bytes(&cache);
+        clock_free(&cache);
+        break;
+    }
+    case POLICY_ARC: {
+        ArcCache cache;
+        arc_init(&cache, n_frames);
+        while (ref_trace_next(refs, &page)) faults += arc_reference(&cache, page, &frame, &victim);
+        bytes = arc_metadata_bytes(&cache);
+        arc_free(&cache);
+        break;
+    }
+    case POLICY_2Q: {
+        TwoQCache cache;
+        twoq_init(&cache, n_frames);
+        while (ref_trace_next(refs, &page)) faults += twoq_reference(&cache, page, &frame, &victim);
+        bytes = twoq_metadata_bytes(&cache);
+        twoq_free(&cache);
+        break;
+    }
+    case POLICY_LIRS: {
+        LirsCache cache;
+        lirs_init(&cache, n_frames);
+        while (ref_trace_next(refs, &page)) faults += lirs_reference(&cache, page, &frame, &victim);
+        bytes = lirs_metadata_bytes(&cache);
+        lirs_free(&cache);
+        break;
+    }
+    default:
+        break;
+    }
+    if (metadata != NULL) *metadata = bytes;
+    return faults;
+}
+
+/**
+ * @brief Runs every policy on the same reference string without tracing and
+ *        prints faults, hit rate, metadata size and hits per KB of metadata.
+ *
+ * Metadata counts what each policy allocates to decide what to evict: the
+ * page lookup map, list links, reference bits and ghost entries. OPT needs
+ * the whole future reference string, so it is listed as the lower bound on
+ * faults but left out when picking the most metadata-efficient policy.
+ */
+void run_comparison(RefTrace* refs, int n_frames) {
+    int faults[N_POLICIES];
+    size_t metadata[N_POLICIES];
+    int n_pages = (int)refs->count;
+
+    for (int p = 0; p < N_POLICIES; p++) {
+        faults[p] = replay_policy((Policy)p, refs, n_frames, NULL, &metadata[p]);
+    }
+
+    int best = -1;
+    double best_efficiency = -1;
+    printf("\n---=== [ Policy Comparison: %d references, %d frames ] ===---\n", n_pages, n_frames);
+    printf("Policy\t\tFaults\t\tHit Rate\tMetadata (B)\tHits/KB\n");
+    for (int p = 0; p < N_POLICIES; p++) {
+        int hits = n_pages - faults[p];
+        double efficiency = hits / (metadata[p] / 1024.0);
+        printf("%-8s\t%-8d\t%6.2f%%\t\t%-12zu\t%.2f\n", policy_names[p], faults[p],
+               100.0 * hits / n_pages, metadata[p], efficiency);
+        if (p != POLICY_OPT && efficiency > best_efficiency) {
+            best_efficiency = efficiency;
+            best = p;
+        }
+    }
+    printf("Best hit rate per KB of metadata: %s\n", policy_names[best]);
+}
+
+/**
+ * @brief Replay worker: claims (policy, frames) jobs until none are left.
+ *        Each worker decodes the shared trace through its own cursor.
+ */
+void* replay_worker(void* arg) {
+    ReplayContext* ctx = (ReplayContext*)arg;
+    RefTrace refs = *ctx->trace; // Private cursor over the shared, read-only data
+
+    while (1) {
+        int j = __atomic_fetch_add(&ctx->next_job, 1, __ATOMIC_RELAXED);
+        if (j >= ctx->n_jobs) break;
+        ReplayJob* job = &ctx->jobs[j];
+        job->faults = replay_policy(job->policy, &refs, job->n_frames, ctx->next_use, NULL);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Replays every policy at every frame count in 'frames' on a thread
+ *        pool over one shared trace and prints the merged fault table, with
+ *        the realizable policy that faults least at each size.
+ */
+void run_replay(RefTrace* refs, const int frames[], int n_sizes, int threads) {
+    ReplayContext ctx;
+    int n_pages = (int)refs->count;
+
+    if (threads <= 0) threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    ctx.trace = refs;
+    ctx.n_jobs = n_sizes * N_POLICIES;
+    ctx.next_job = 0;
+    ctx.jobs = (ReplayJob*)calloc(ctx.n_jobs, sizeof(ReplayJob));
+    ctx.next_use = opt_next_uses(refs); // Shared by every OPT job instead of one copy each
+    // Largest sizes first: they run longest, so the pool does not end on a straggler.
+    for (int s = 0; s < n_sizes; s++) {
+        for (int p = 0; p < N_POLICIES; p++) {
+            ctx.jobs[s * N_POLICIES + p].policy = (Policy)p;
+            ctx.jobs[s * N_POLICIES + p].n_frames = frames[n_sizes - 1 - s];
+        }
+    }
+
+    if (threads < 1) threads = 1;
+    if (threads > ctx.n_jobs) threads = ctx.n_jobs;
+    pthread_t* pool = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    for (int t = 0; t < threads; t++) {
+        pthread_create(&pool[t], NULL, replay_worker, &ctx);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(pool[t], NULL);
+    }
+
+    printf("\n---=== [ Parallel Replay: %d references, %d runs, %d threads ] ===---\n", n_pages, ctx.n_jobs, threads);
+    printf("Frames");
+    for (int p = 0; p < N_POLICIES; p++) printf("\t%s", policy_names[p]);
+    printf("\tBest\n");
+    for (int s = n_sizes - 1; s >= 0; s--) {
+        const ReplayJob* row = &ctx.jobs[s * N_POLICIES];
+        int best = -1;
+        printf("%d", row[0].n_frames);
+        for (int p = 0; p < N_POLICIES; p++) {
+            printf("\t%d", row[p].faults);
+            if (p != POLICY_OPT && (best == -1 || row[p].faults < row[best].faults)) best = p;
+        }
+        printf("\t%s\n", policy_names[best]);
+    }
+
+    free(pool);
+    free(ctx.jobs);
+    free(ctx.next_use);
+}
+
+/**
+ * @brief Parses a frame-count list such as "4,8,16-32:4" (ranges with an
+ *        optional step) into ascending sizes.
+ * @return Newly allocated array, or NULL if the list is malformed.
+ */
+int* parse_frame_list(const char* list, int* n_sizes) {
+    int capacity = 16, n = 0;
+    int* sizes = (int*)malloc(capacity * sizeof(int));
+    const char* p = list;
+
+    while (*p != '\0') {
+        char* end;
+        long first = strtol(p, &end, 10), last, step = 1;
+        if (end == p || first < 1) goto bad_list;
+        last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            if (end == p + 1 || last < first) goto bad_list;
+            p = end;
+            if (*p == ':') {
+                step = strtol(p + 1, &end, 10);
+                if (end == p + 1 || step < 1) goto bad_list;
+                p = end;
+            }
+        }
+        for (long f = first; f <= last && f <= 0x7fffffff; f += step) {
+            if (n == capacity) {
+                capacity *= 2;
+                sizes = (int*)realloc(sizes, capacity * sizeof(int));
             }
-            frames[lru_index] = pages[i];
-            time_since_use[lru_index] = 0; // Reset its counter
-            print_frames(frames, n_frames);
-            printf("(Fault)\n");
-        } else { // Page Hit
-            time_since_use[found_index] = 0; // Reset its counter
-            print_frames(frames, n_frames);
-            printf("(Hit)\n");
+            sizes[n++] = (int)f;
+        }
+        if (*p == ',') p++;
+        else if (*p != '\0') goto bad_list;
+    }
+    if (n == 0) goto bad_list;
+    qsort(sizes, n, sizeof(int), compare_int);
+    *n_sizes = n;
+    return sizes;
+
+bad_list:
+    fprintf(stderr, "Bad frame list '%s' (expected e.g. 4,8,16-64:16)\n", list);
+    free(sizes);
+    return NULL;
+}
+
+int compare_int(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief 4KB virtual page number of a reference. Trace files keep each id's
+ *        page number at the page size they were cut with; typed-in pages are
+ *        taken as 4KB page numbers.
+ */
+uint64_t virtual_page(const RefTrace* refs, int page) {
+    uint64_t number = ref_trace_page_number(refs, page);
+    int shift = (int)refs->page_shift;
+    if (shift == 0 || shift == TLB_BASE_PAGE_SHIFT) return number;
+    return (shift > TLB_BASE_PAGE_SHIFT) ? number << (shift - TLB_BASE_PAGE_SHIFT)
+                                         : number >> (TLB_BASE_PAGE_SHIFT - shift);
+}
+
+/**
+ * @brief Replays one policy behind a TLB and a 4-level page table.
+ *
+ * Every reference first looks up the TLB. A miss walks the page table (its
+ * entry reads are the walk memory references) and, if the page is not
+ * resident, faults into the frame policy; the evicted page's leaf is marked
+ * not present and its TLB entry shot down. With huge pages the policy
+ * manages 2MB pages, so each of its frames is 512 4KB frames.
+ *
+ * @param next_use OPT next uses over the policy's pages (ids, or 2MB page numbers if huge).
+ */
+TranslationStats replay_translated(Policy policy, RefTrace* refs, int huge, int n_frames,
+                                   int sets, int ways, const int next_use[]) {
+    TranslationStats stats = { 0, 0, 0, 0 };
+    FifoCache fifo;
+    LruCache lru;
+    OptCache opt;
+    Tlb tlb;
+    PageTable pt;
+    int page, frame, victim, fault = 0;
+
+    switch (policy) {
+    case POLICY_FIFO: fifo_init(&fifo, n_frames); break;
+    case POLICY_LRU: lru_init(&lru, n_frames); break;
+    default: opt_init_shared(&opt, next_use, (int)refs->count, n_frames); break;
+    }
+    tlb_init(&tlb, sets, ways);
+    pt_init(&pt, huge);
+
+    ref_trace_rewind(refs);
+    for (int i = 0; ref_trace_next(refs, &page); i++) {
+        uint64_t vpn = virtual_page(refs, page);
+        uint64_t mapped = huge ? vpn >> HUGE_PAGE_SHIFT : vpn; // Page number at the mapping size
+        int key = huge ? (int)mapped : page;                     // Page as the frame policy sees it
+
+        switch (policy) {
+        case POLICY_FIFO: fault = fifo_reference(&fifo, key, &frame, &victim); break;
+        case POLICY_LRU: fault = lru_reference(&lru, key, &frame, &victim); break;
+        default: fault = opt_reference(&opt, key, i, &frame, &victim); break;
         }
+        stats.faults += fault;
+        if (tlb_lookup(&tlb, mapped, huge)) continue; // Resident: evictions shoot down their entries
 
-        // Increment time for all pages currently in frames
-        for (int j = 0; j < n_frames; j++) {
-            if (frames[j] != -1) time_since_use[j]++;
+        stats.tlb_misses++;
+        pt_walk(&pt, vpn, &stats.walk_refs);
+        if (fault) {
+            if (victim != -1) {
+                uint64_t evicted = huge ? (uint64_t)victim << HUGE_PAGE_SHIFT : virtual_page(refs, victim);
+                pt_set_present(&pt, evicted, 0);
+                tlb_invalidate(&tlb, huge ? evicted >> HUGE_PAGE_SHIFT : evicted, huge);
+            }
+            pt_set_present(&pt, vpn, 1);
         }
+        tlb_insert(&tlb, mapped, huge);
     }
-    printf("Total Page Faults (LRU): %d\n", page_faults);
-    free(frames);
-    free(time_since_use);
+    stats.table_nodes = pt.n_nodes;
+
+    switch (policy) {
+    case POLICY_FIFO: fifo_free(&fifo); break;
+    case POLICY_LRU: lru_free(&lru); break;
+    default: opt_free(&opt); break;
+    }
+    tlb_free(&tlb);
+    pt_free(&pt);
+    return stats;
 }
 
 /**
- * @brief Simulates Optimal (OPT)
+ * @brief Runs FIFO, LRU and OPT behind the TLB and page table with 4KB pages
+ *        and again with 2MB huge pages in the same memory, and prints TLB miss
+ *        rate, walk memory references and faults side by side.
+ * @param n_frames Physical memory in 4KB frames.
  */
-void run_optimal(int pages[], int n_pages, int n_frames) {
-    int *frames = (int*)calloc(n_frames, sizeof(int));
-    for(int i = 0; i < n_frames; i++) frames[i] = -1;
+void run_tlb(RefTrace* refs, int n_frames, int sets, int ways) {
+    const Policy policies[] = { POLICY_FIFO, POLICY_LRU, POLICY_OPT };
+    const int n_policies = 3;
+    TranslationStats stats[2][3];
+    int n_pages = (int)refs->count, page;
+    int huge_frames = n_frames >> HUGE_PAGE_SHIFT;
+    if (huge_frames < 1) huge_frames = 1;
 
-    int page_faults = 0;
+    // OPT needs next uses over the pages each configuration's policy manages.
+    int* next_use = opt_next_uses(refs);
+    int* huge_pages = (int*)malloc((n_pages ? n_pages : 1) * sizeof(int));
+    ref_trace_rewind(refs);
+    for (int i = 0; ref_trace_next(refs, &page); i++) {
+        huge_pages[i] = (int)(virtual_page(refs, page) >> HUGE_PAGE_SHIFT);
+    }
+    RefTrace huge_refs;
+    ref_trace_from_array(&huge_refs, huge_pages, n_pages);
+    int* huge_next_use = opt_next_uses(&huge_refs);
 
-    printf("\n---=== [ Optimal Simulation ] ===---\n");
-    for (int i = 0; i < n_pages; i++) {
-        printf("Ref: %d", pages[i]);
-        if (find_page(frames, n_frames, pages[i]) == -1) { // Page Fault
-            page_faults++;
-            
-            // Find an empty frame first
-            int empty_index = find_page(frames, n_frames, -1);
-            if (empty_index != -1) {
-                frames[empty_index] = pages[i];
-            } else {
-                // All frames full, find the optimal page to replace
-                int replace_index = -1;
-                int farthest_use = -1;
-
-                for (int j = 0; j < n_frames; j++) {
-                    // Look ahead in the future string
-                    int k;
-                    for (k = i + 1; k < n_pages; k++) {
-                        if (frames[j] == pages[k]) {
-                            if (k > farthest_use) {
-                                farthest_use = k;
-                                replace_index = j;
-                            }
-                            break;
-                        }
-                    }
-                    if (k == n_pages) { // This page is not used again
-                        replace_index = j;
-                        goto found_victim; // Easiest victim, replace it
-                    }
-                }
-                found_victim:
-                frames[replace_index] = pages[i];
+    for (int p = 0; p < n_policies; p++) {
+        stats[0][p] = replay_translated(policies[p], refs, 0, n_frames, sets, ways, next_use);
+        stats[1][p] = replay_translated(policies[p], refs, 1, huge_frames, sets, ways, huge_next_use);
+    }
+
+    printf("\n---=== [ Address Translation: %d references, %d KB of memory, TLB %d sets x %d ways ] ===---\n",
+           n_pages, n_frames * 4, sets, ways);
+    printf("Pages\tFrames\tPolicy\t\tTLB Miss\tWalk Refs\tRefs/Access\tFaults\t\tTable KB\n");
+    for (int h = 0; h < 2; h++) {
+        for (int p = 0; p < n_policies; p++) {
+            TranslationStats* s = &stats[h][p];
+            printf("%s\t%-6d\t%-8s\t%6.2f%%\t\t%-12lld\t%-8.3f\t%-8d\t%d\n", h ? "2MB" : "4KB",
+                   h ? huge_frames : n_frames, policy_names[policies[p]], 100.0 * s->tlb_misses / n_pages,
+                   s->walk_refs, (double)s->walk_refs / n_pages, s->faults, s->table_nodes * PT_NODE_BYTES / 1024);
+        }
+    }
+
+    // Huge pages pay off when the walks they save outweigh the faults they add.
+    TranslationStats *small = &stats[0][1], *large = &stats[1][1];
+    printf("2MB vs 4KB pages (LRU): TLB misses %+.1f%%, walk references %+.1f%%, faults %+.1f%%\n",
+           small->tlb_misses ? 100.0 * (large->tlb_misses - small->tlb_misses) / small->tlb_misses : 0.0,
+           small->walk_refs ? 100.0 * (large->walk_refs - small->walk_refs) / small->walk_refs : 0.0,
+           small->faults ? 100.0 * (large->faults - small->faults) / small->faults : 0.0);
+
+    free(next_use);
+    free(huge_pages);
+    free(huge_next_use);
+}
+
+/**
+ * @brief Reads "count, then that many PID page pairs" from stdin and renumbers
+ *        processes and (process, page) pairs densely.
+ * @return 0 on success, -1 on bad input.
+ */
+int read_multi_trace(MultiTrace* mt) {
+    PageMap procs, pages;
+    int pid, page;
+
+    if (scanf("%d", &mt->n_refs) != 1 || mt->n_refs <= 0) return -1;
+    mt->proc = (int*)malloc(mt->n_refs * sizeof(int));
+    mt->page = (int*)malloc(mt->n_refs * sizeof(int));
+    mt->pids = (int*)malloc(mt->n_refs * sizeof(int));
+    mt->proc_refs = (int*)calloc(mt->n_refs, sizeof(int));
+    mt->proc_pages = (int*)calloc(mt->n_refs, sizeof(int));
+    mt->n_procs = mt->n_pages = 0;
+    page_map_init(&procs, 16);
+    page_map_init(&pages, 1024);
+
+    for (int i = 0; i < mt->n_refs; i++) {
+        if (scanf("%d %d", &pid, &page) != 2) {
+            fprintf(stderr, "Expected %d PID page pairs, got %d.\n", mt->n_refs, i);
+            page_map_free(&procs);
+            page_map_free(&pages);
+            multi_trace_free(mt);
+            return -1;
+        }
+        int p = page_map_get(&procs, (uint32_t)pid);
+        if (p == -1) {
+            p = mt->n_procs++;
+            mt->pids[p] = pid;
+            page_map_put(&procs, (uint32_t)pid, p);
+        }
+        uint64_t key = ((uint64_t)p << 32) | (uint32_t)page;
+        int id = page_map_get(&pages, key);
+        if (id == -1) {
+            id = mt->n_pages++;
+            mt->proc_pages[p]++;
+            page_map_put(&pages, key, id);
+        }
+        mt->proc[i] = p;
+        mt->page[i] = id;
+        mt->proc_refs[p]++;
+    }
+    page_map_free(&procs);
+    page_map_free(&pages);
+    return 0;
+}
+
+void multi_trace_free(MultiTrace* mt) {
+    free(mt->proc);
+    free(mt->page);
+    free(mt->pids);
+    free(mt->proc_refs);
+    free(mt->proc_pages);
+}
+
+/**
+ * @brief Replays the interleaved references with one frame allocation strategy.
+ *
+ * - Global LRU: any process may take any frame; the LRU page in memory goes.
+ * - Fixed: every process gets n_frames / n_procs frames and replaces its own LRU page.
+ * - Proportional: allocations follow each process's distinct page count.
+ * - Working set: a process's allocation is its working set over its last
+ *   'window' references, and pages leaving the working set are released.
+ * - PFF: a process gains a frame when it faults again within 'window' of its
+ *   own references, as long as the allocations still fit in memory, and gives
+ *   one back (down to one) when faults are further apart.
+ * Local strategies replace LRU within the process (see PartitionCache).
+ *
+ * @param proc_faults Receives each process's fault count.
+ * @param thrashing Receives the share of THRASH_EPOCH-reference epochs faulting
+ *        on more than THRASH_FAULT_RATE of their references.
+ * @param overcommitted Receives the share of references at which the
+ *        allocations added up to more than memory (working set) or a
+ *        process's last request for a frame was refused (PFF).
+ * @return Total page faults.
+ */
+int simulate_allocation(Allocation strategy, const MultiTrace* mt, int n_frames, int window,
+                        int proc_faults[], double* thrashing, double* overcommitted) {
+    PartitionCache cache;
+    WorkingSet ws;
+    int *last_fault = (int*)calloc(mt->n_procs, sizeof(int));
+    int *vtime = (int*)calloc(mt->n_procs, sizeof(int));
+    int *denied = (int*)calloc(mt->n_procs, sizeof(int)); // PFF: last request for a frame was refused
+    int starved = 0;                                     // Processes in that state
+    int faults = 0, epoch_faults = 0, epochs = 0, thrashing_epochs = 0, frame, victim;
+    long long over = 0;
+
+    partition_init(&cache, n_frames, mt->n_procs, strategy == ALLOC_GLOBAL);
+    if (strategy == ALLOC_WORKING_SET) ws_init(&ws, mt->n_procs, mt->n_pages, window);
+    for (int p = 0; p < mt->n_procs; p++) {
+        int share = n_frames / mt->n_procs + (p < n_frames % mt->n_procs);
+        proc_faults[p] = 0;
+        if (strategy == ALLOC_FIXED || strategy == ALLOC_PFF) {
+            partition_set_alloc(&cache, p, share);
+        } else if (strategy == ALLOC_PROPORTIONAL) {
+            int frames = (int)((long long)n_frames * mt->proc_pages[p] / mt->n_pages);
+            partition_set_alloc(&cache, p, frames > 0 ? frames : 1);
+        }
+    }
+
+    for (int i = 0; i < mt->n_refs; i++) {
+        int p = mt->proc[i], page = mt->page[i];
+        vtime[p]++;
+        if (strategy == ALLOC_WORKING_SET) {
+            int left = ws_reference(&ws, p, page);
+            if (left != -1) partition_drop(&cache, left);
+            partition_set_alloc(&cache, p, ws.size[p]);
+        }
+
+        int fault = partition_reference(&cache, p, page, &frame, &victim);
+        if (fault) {
+            faults++;
+            epoch_faults++;
+            proc_faults[p]++;
+            if (strategy == ALLOC_PFF) {
+                int wants_more = vtime[p] - last_fault[p] < window;
+                int refused = wants_more && cache.total_alloc >= n_frames; // Decided before any grant
+                if (wants_more && !refused) partition_set_alloc(&cache, p, cache.alloc[p] + 1);
+                else if (!wants_more && cache.alloc[p] > 1) partition_set_alloc(&cache, p, cache.alloc[p] - 1);
+                starved += refused - denied[p];
+                denied[p] = refused;
+                last_fault[p] = vtime[p];
             }
-            print_frames(frames, n_frames);
-            printf("(Fault)\n");
+        }
+        if (cache.total_alloc > n_frames || starved > 0) over++;
+
+        if ((i + 1) % THRASH_EPOCH == 0 || i + 1 == mt->n_refs) {
+            int length = (i % THRASH_EPOCH) + 1;
+            epochs++;
+            if (epoch_faults > THRASH_FAULT_RATE * length) thrashing_epochs++;
+            epoch_faults = 0;
+        }
+    }
+
+    *thrashing = (double)thrashing_epochs / epochs;
+    *overcommitted = (double)over / mt->n_refs;
+    if (strategy == ALLOC_WORKING_SET) ws_free(&ws);
+    partition_free(&cache);
+    free(last_fault);
+    free(vtime);
+    free(denied);
+    return faults;
+}
+
+/**
+ * @brief Compares global replacement with the local allocation strategies on
+ *        one interleaved multi-process trace and prints overall and
+ *        per-process fault rates.
+ */
+void run_multiprogramming(const MultiTrace* mt, int n_frames, int window) {
+    int *proc_faults = (int*)malloc((size_t)N_ALLOCATIONS * mt->n_procs * sizeof(int));
+    double thrashing, overcommitted;
+
+    printf("\n---=== [ Multiprogramming: %d references, %d processes, %d frames, window %d ] ===---\n",
+           mt->n_refs, mt->n_procs, n_frames, window);
+    printf("Allocation\tFaults\t\tFault Rate\tThrashing\tOvercommitted\n");
+    for (int a = 0; a < N_ALLOCATIONS; a++) {
+        int faults = simulate_allocation((Allocation)a, mt, n_frames, window,
+                                         proc_faults + (size_t)a * mt->n_procs, &thrashing, &overcommitted);
+        printf("%-12s\t%-8d\t%6.2f%%\t\t%6.2f%%\t\t%6.2f%%\n", allocation_names[a], faults,
+               100.0 * faults / mt->n_refs, 100.0 * thrashing, 100.0 * overcommitted);
+    }
+    printf("Thrashing: share of %d-reference epochs faulting on over %.0f%% of references.\n",
+           THRASH_EPOCH, 100 * THRASH_FAULT_RATE);
+    printf("Overcommitted: share of references at which the allocations exceeded memory\n"
+           "or a process was refused the frame it asked for.\n");
+
+    printf("\nPer-process fault rate (! = over %.0f%%):\n", 100 * THRASH_FAULT_RATE);
+    printf("PID\tRefs\tPages");
+    for (int a = 0; a < N_ALLOCATIONS; a++) printf("\t%s", allocation_names[a]);
+    printf("\n");
+    for (int p = 0; p < mt->n_procs; p++) {
+        printf("%d\t%d\t%d", mt->pids[p], mt->proc_refs[p], mt->proc_pages[p]);
+        for (int a = 0; a < N_ALLOCATIONS; a++) {
+            double rate = (double)proc_faults[(size_t)a * mt->n_procs + p] / mt->proc_refs[p];
+            printf("\t%6.2f%%%s", 100 * rate, rate > THRASH_FAULT_RATE ? "!" : " ");
+        }
+        printf("\n");
+    }
+    free(proc_faults);
+}
+
+/**
+ * @brief Prints the LRU miss-ratio curve as CSV (frames,faults,miss_ratio).
+ * @param max_frames Largest frame count to report, 0 for the number of distinct pages
+ *        (beyond which only cold misses remain).
+ */
+void run_mrc(RefTrace* refs, int max_frames) {
+    int n_pages = (int)refs->count;
+    long long *hist = (long long*)calloc(n_pages + 1, sizeof(long long));
+    int distinct;
+    lru_stack_distances(refs, hist, &distinct);
+    if (max_frames == 0) max_frames = distinct;
+
+    // Faults with F frames: every reference except re-references at distance <= F.
+    long long faults = n_pages;
+    printf("frames,faults,miss_ratio\n");
+    for (int f = 1; f <= max_frames; f++) {
+        if (f <= n_pages) faults -= hist[f];
+        printf("%d,%lld,%.6f\n", f, faults, (double)faults / n_pages);
+    }
+    free(hist);
+}
+
+/**
+ * @brief Prints the SHARDS estimate of the LRU miss-ratio curve as CSV.
+ * @param check Also compute the exact curve and print the absolute error per
+ *        frame count plus its mean and maximum (on stderr).
+ */
+void run_shards(RefTrace* refs, int sample_pages, int max_frames, int check) {
+    ShardsSampler sampler;
+    int n_pages = (int)refs->count;
+    int page;
+    shards_init(&sampler, sample_pages, max_frames);
+    ref_trace_rewind(refs);
+    while (ref_trace_next(refs, &page)) {
+        shards_reference(&sampler, page);
+    }
+    shards_adjust(&sampler);
+
+    long long *hist = NULL;
+    long long exact_faults = n_pages;
+    double hits = 0, total_error = 0, max_error = 0;
+    if (check) {
+        int distinct;
+        hist = (long long*)calloc(n_pages + 1, sizeof(long long));
+        lru_stack_distances(refs, hist, &distinct);
+        printf("frames,miss_ratio,exact_miss_ratio,abs_error\n");
+    } else {
+        printf("frames,miss_ratio\n");
+    }
+
+    for (int f = 1; f <= max_frames; f++) {
+        hits += sampler.hist[f];
+        double estimate = sampler.total > 0 ? 1.0 - hits / sampler.total : 0.0;
+        if (estimate < 0) estimate = 0; // The adjustment can overshoot at the smallest sizes
+        if (estimate > 1) estimate = 1;
+        if (check) {
+            if (f <= n_pages) exact_faults -= hist[f];
+            double exact = (double)exact_faults / n_pages;
+            double error = estimate > exact ? estimate - exact : exact - estimate;
+            total_error += error;
+            if (error > max_error) max_error = error;
+            printf("%d,%.6f,%.6f,%.6f\n", f, estimate, exact, error);
         } else {
-            print_frames(frames, n_frames);
-            printf("(Hit)\n");
+            printf("%d,%.6f\n", f, estimate);
         }
     }
-    printf("Total Page Faults (Optimal): %d\n", page_faults);
-    free(frames);
-}
\ No newline at end of file
+
+    fprintf(stderr, "Sampled %lld of %d references, final rate %.5f, %d pages tracked\n",
+            sampler.sampled, n_pages, (double)sampler.threshold / SHARDS_MODULUS, sampler.marked);
+    if (check) {
+        fprintf(stderr, "Mean absolute error %.5f, max %.5f\n", total_error / max_frames, max_error);
+    }
+    free(hist);
+    shards_free(&sampler);
+}
@@ -0,0 +1,269 @@
+/*
+ * ref_trace.h
+ * ===========
+ * Compact page reference traces for the page replacement simulators.
+ *
+ * trace_ingest converts raw address traces into this format; the simulators
+ * then replay it straight from an mmap'ed file, decoding one reference at a
+ * time, so a trace never has to be loaded into an int array.
+ *
+ * File layout (little endian):
+ *   char     magic[4]      "PGTR"
+ *   uint32   version       REF_TRACE_VERSION
+ *   uint32   page_shift    log2 of the page size the addresses were cut with
+ *   uint32   reserved      0
+ *   uint64   count         number of references
+ *   uint64   distinct      number of distinct pages (ids are 0..distinct-1)
+ *   uint64   table_offset  file offset of the id -> page number table
+ *   ...      references    one varint per reference (see below)
+ *   uint64   pages[distinct]  original page number of each id
+ *
+ * Pages are renumbered with dense 32-bit ids in order of first use. Each
+ * reference stores the difference from the previous id, zigzag-encoded (so
+ * small negative steps stay small) as an LEB128 varint: 7 bits per byte, high
+ * bit set on every byte but the last. Loops over a working set mostly take
+ * one or two bytes per reference instead of four.
+ *
+ * A RefTrace can also wrap an ordinary int array, so the same replay loop
+ * serves typed-in reference strings and trace files.
+ *
+ * Every function is static inline so each simulator can include this header
+ * directly and still be compiled on its own.
+ */
+
+#ifndef REF_TRACE_H
+#define REF_TRACE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define REF_TRACE_MAGIC "PGTR"
+#define REF_TRACE_VERSION 1
+#define REF_TRACE_HEADER_SIZE 40
+#define REF_TRACE_BUFFER (1 << 16) // Writer buffer size in bytes
+
+/* Reference iterator over an mmap'ed trace file or an in-memory array */
+typedef struct {
+    const int *pages;              // Array-backed: the references, NULL for a file
+    const unsigned char *map;      // File-backed: the whole mapping
+    size_t map_len;
+    const unsigned char *body;     // First encoded reference
+    const unsigned char *end;      // End of the encoded references
+    const unsigned char *pos;      // Next byte to decode
+    const unsigned char *table;    // id -> page number table, NULL for arrays
+    uint64_t count;                // Number of references
+    uint64_t distinct;             // Distinct pages, 0 if unknown (arrays)
+    uint64_t next;                 // Index of the next reference
+    uint32_t last;                 // Previously decoded id
+    uint32_t page_shift;           // log2 page size, 0 if unknown
+} RefTrace;
+
+/**
+ * @brief Wraps an existing reference array; the array must outlive the trace.
+ */
+static inline void ref_trace_from_array(RefTrace* t, const int pages[], int n_pages) {
+    memset(t, 0, sizeof(*t));
+    t->pages = pages;
+    t->count = (uint64_t)n_pages;
+}
+
+static inline uint64_t ref_trace_read_u64(const unsigned char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Maps a trace file for replay and checks its header.
+ * @return 0 on success, -1 on error (message on stderr).
+ */
+static inline int ref_trace_open(RefTrace* t, const char* path) {
+    struct stat st;
+    int fd = open(path, O_RDONLY);
+    uint32_t version;
+
+    memset(t, 0, sizeof(*t));
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    if (st.st_size < REF_TRACE_HEADER_SIZE) {
+        fprintf(stderr, "%s: not a page reference trace\n", path);
+        close(fd);
+        return -1;
+    }
+
+    const unsigned char* data = (const unsigned char*)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+    madvise((void*)data, st.st_size, MADV_SEQUENTIAL);
+
+    memcpy(&version, data + 4, sizeof(version));
+    memcpy(&t->page_shift, data + 8, sizeof(t->page_shift));
+    t->count = ref_trace_read_u64(data + 16);
+    t->distinct = ref_trace_read_u64(data + 24);
+    uint64_t table_offset = ref_trace_read_u64(data + 32);
+    if (memcmp(data, REF_TRACE_MAGIC, 4) != 0 || version != REF_TRACE_VERSION ||
+        table_offset < REF_TRACE_HEADER_SIZE || table_offset > (uint64_t)st.st_size ||
+        (uint64_t)st.st_size - table_offset != t->distinct * sizeof(uint64_t) ||
+        t->count > 0x7fffffff || t->distinct > 0x7fffffff) {
+        fprintf(stderr, "%s: corrupt trace header\n", path);
+        munmap((void*)data, st.st_size);
+        return -1;
+    }
+
+    t->map = data;
+    t->map_len = st.st_size;
+    t->body = t->pos = data + REF_TRACE_HEADER_SIZE;
+    t->end = data + table_offset;
+    t->table = data + table_offset;
+    return 0;
+}
+
+static inline void ref_trace_close(RefTrace* t) {
+    if (t->map != NULL) munmap((void*)t->map, t->map_len);
+    t->map = NULL;
+}
+
+/**
+ * @brief Restarts the replay from the first reference.
+ */
+static inline void ref_trace_rewind(RefTrace* t) {
+    t->pos = t->body;
+    t->next = 0;
+    t->last = 0;
+}
+
+/**
+ * @brief Decodes the next reference.
+ * @return 1 with *page set, or 0 at the end of the trace (or if it is truncated).
+ */
+static inline int ref_trace_next(RefTrace* t, int* page) {
+    if (t->next >= t->count) return 0;
+    if (t->pages != NULL) {
+        *page = t->pages[t->next++];
+        return 1;
+    }
+
+    uint64_t zigzag = 0;
+    int shift = 0;
+    while (1) {
+        if (t->pos >= t->end || shift > 63) {
+            fprintf(stderr, "Trace truncated after %llu references\n", (unsigned long long)t->next);
+            t->count = t->next;
+            return 0;
+        }
+        unsigned char byte = *t->pos++;
+        zigzag |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+        shift += 7;
+    }
+    int64_t delta = (int64_t)(zigzag >> 1) ^ -(int64_t)(zigzag & 1);
+    t->last = (uint32_t)((int64_t)t->last + delta);
+    t->next++;
+    *page = (int)t->last;
+    return 1;
+}
+
+/**
+ * @brief Original page number of a dense id (the id itself for array traces).
+ */
+static inline uint64_t ref_trace_page_number(const RefTrace* t, int id) {
+    if (t->table == NULL) return (uint64_t)id;
+    return ref_trace_read_u64(t->table + (size_t)id * sizeof(uint64_t));
+}
+
+/* Streaming encoder for the format above */
+typedef struct {
+    FILE *fp;
+    unsigned char *buf;
+    size_t len;           // Bytes waiting in buf
+    uint32_t last;        // Previously written id
+    uint32_t page_shift;
+    uint64_t count;
+    uint64_t bytes;       // Encoded reference bytes written so far
+} RefTraceWriter;
+
+/**
+ * @brief Creates a trace file; the header is completed by ref_trace_finish().
+ * @return 0 on success, -1 on I/O error.
+ */
+static inline int ref_trace_create(RefTraceWriter* w, const char* path, uint32_t page_shift) {
+    unsigned char header[REF_TRACE_HEADER_SIZE] = { 0 };
+    w->fp = fopen(path, "wb");
+    if (w->fp == NULL) {
+        perror(path);
+        return -1;
+    }
+    w->buf = (unsigned char*)malloc(REF_TRACE_BUFFER);
+    w->len = 0;
+    w->last = 0;
+    w->page_shift = page_shift;
+    w->count = 0;
+    w->bytes = 0;
+    fwrite(header, 1, sizeof(header), w->fp); // Placeholder until the counts are known
+    return 0;
+}
+
+static inline void ref_trace_flush(RefTraceWriter* w) {
+    fwrite(w->buf, 1, w->len, w->fp);
+    w->bytes += w->len;
+    w->len = 0;
+}
+
+/**
+ * @brief Appends one reference (a dense id) as a zigzag delta varint.
+ */
+static inline void ref_trace_append(RefTraceWriter* w, uint32_t id) {
+    int64_t delta = (int64_t)id - (int64_t)w->last;
+    uint64_t zigzag = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+
+    if (w->len + 10 > REF_TRACE_BUFFER) ref_trace_flush(w);
+    while (zigzag >= 0x80) {
+        w->buf[w->len++] = (unsigned char)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    w->buf[w->len++] = (unsigned char)zigzag;
+    w->last = id;
+    w->count++;
+}
+
+/**
+ * @brief Writes the id -> page number table, fills in the header and closes the file.
+ * @return 0 on success, -1 on I/O error.
+ */
+static inline int ref_trace_finish(RefTraceWriter* w, const uint64_t page_numbers[], uint64_t distinct) {
+    uint32_t version = REF_TRACE_VERSION, reserved = 0;
+    uint64_t table_offset;
+    int status = 0;
+
+    ref_trace_flush(w);
+    table_offset = REF_TRACE_HEADER_SIZE + w->bytes;
+    fwrite(page_numbers, sizeof(uint64_t), distinct, w->fp);
+
+    fseek(w->fp, 0, SEEK_SET);
+    fwrite(REF_TRACE_MAGIC, 1, 4, w->fp);
+    fwrite(&version, sizeof(version), 1, w->fp);
+    fwrite(&w->page_shift, sizeof(w->page_shift), 1, w->fp);
+    fwrite(&reserved, sizeof(reserved), 1, w->fp);
+    fwrite(&w->count, sizeof(w->count), 1, w->fp);
+    fwrite(&distinct, sizeof(distinct), 1, w->fp);
+    fwrite(&table_offset, sizeof(table_offset), 1, w->fp);
+    if (ferror(w->fp)) status = -1;
+    if (fclose(w->fp) != 0) status = -1;
+    if (status != 0) perror("write trace");
+    free(w->buf);
+    return status;
+}
+
+#endif // REF_TRACE_H
@@ -0,0 +1,1369 @@
+/*
+ * replacement.h
+ * =============
+ * Page replacement engines shared by page_replacement.c, lru.c and optimal.c.
+ *
+ * Each engine keeps its own frame table (the same "page per frame, -1 for
+ * empty" array the simulators print) plus the indexes it needs so that a
+ * reference costs O(1) or O(log frames) instead of a scan over every frame:
+ * - LruCache: page -> frame hash map plus a doubly linked recency list over
+ *   the frames. Lookup, promotion to most recently used and eviction of the
+ *   least recently used page are all O(1).
+ * - OptCache: Belady's optimal policy. One forward pass over the reference
+ *   string, remembering where each page was last seen, records where each
+ *   reference's page is used next; resident frames sit in a max-heap keyed
+ *   on that next use, so a fault costs O(log frames).
+ * - FifoCache, ClockCache: FIFO and CLOCK (second chance) with the same
+ *   page -> frame map; CLOCK's hand sweep is O(1) amortized.
+ * - ArcCache, TwoQCache, LirsCache: scan-resistant policies that also
+ *   remember recently evicted pages (ARC, 2Q, LIRS). Lists are threaded
+ *   through a fixed node pool, so every reference is O(1) amortized and
+ *   memory is bounded by a small multiple of the frame count.
+ * - lru_stack_distances: Mattson's stack algorithm. One pass yields the LRU
+ *   fault count for every frame count at once (a miss-ratio curve).
+ * - ShardsSampler: the same curve estimated from a hash-sampled subset of
+ *   pages (fixed-size SHARDS) in memory that does not grow with the trace.
+ * - PartitionCache: LRU over frames shared by several processes, with
+ *   global replacement or local replacement under per-process allocations;
+ *   WorkingSet tracks each process's working set for allocation.
+ *
+ * Every function is static inline so each simulator can include this header
+ * directly and still be compiled on its own.
+ */
+
+#ifndef REPLACEMENT_H
+#define REPLACEMENT_H
+
+#include <stdlib.h>
+#include <string.h>
+#include "page_map.h"
+#include "ref_trace.h"
+
+/* LRU state: frames linked from most to least recently used */
+typedef struct {
+    int n_frames;
+    int *frame_page;  // Page held by each frame, -1 if empty
+    int *older;       // Next less recently used frame, -1 at the LRU end
+    int *newer;       // Next more recently used frame, -1 at the MRU end
+    int mru;          // Most recently used frame, -1 while all are empty
+    int lru;          // Least recently used frame (the next victim)
+    int used;         // Frames filled so far; free frames are taken in index order
+    PageMap where;    // Resident page -> frame
+} LruCache;
+
+static inline void lru_init(LruCache* c, int n_frames) {
+    c->n_frames = n_frames;
+    c->frame_page = (int*)malloc(n_frames * sizeof(int));
+    c->older = (int*)malloc(n_frames * sizeof(int));
+    c->newer = (int*)malloc(n_frames * sizeof(int));
+    for (int f = 0; f < n_frames; f++) c->frame_page[f] = -1;
+    c->mru = c->lru = -1;
+    c->used = 0;
+    page_map_init(&c->where, n_frames);
+}
+
+static inline void lru_free(LruCache* c) {
+    free(c->frame_page);
+    free(c->older);
+    free(c->newer);
+    page_map_free(&c->where);
+}
+
+// Unlinks frame f from the recency list.
+static inline void lru_unlink(LruCache* c, int f) {
+    if (c->newer[f] != -1) c->older[c->newer[f]] = c->older[f];
+    else c->mru = c->older[f];
+    if (c->older[f] != -1) c->newer[c->older[f]] = c->newer[f];
+    else c->lru = c->newer[f];
+}
+
+// Links frame f in as the most recently used.
+static inline void lru_push_mru(LruCache* c, int f) {
+    c->newer[f] = -1;
+    c->older[f] = c->mru;
+    if (c->mru != -1) c->newer[c->mru] = f;
+    else c->lru = f;
+    c->mru = f;
+}
+
+/**
+ * @brief References 'page': a hit moves it to the MRU end; a fault loads it
+ *        into a free frame or, when memory is full, into the LRU frame.
+ * @param frame Receives the frame now holding the page.
+ * @param victim Receives the evicted page, -1 if nothing was evicted.
+ * @return 1 on a page fault, 0 on a hit.
+ */
+static inline int lru_reference(LruCache* c, int page, int* frame, int* victim) {
+    int f = page_map_get(&c->where, (uint64_t)page);
+    *victim = -1;
+
+    if (f != -1) {
+        if (f != c->mru) {
+            lru_unlink(c, f);
+            lru_push_mru(c, f);
+        }
+        *frame = f;
+        return 0;
+    }
+
+    if (c->used < c->n_frames) {
+        f = c->used++;
+    } else {
+        f = c->lru;
+        *victim = c->frame_page[f];
+        page_map_remove(&c->where, (uint64_t)*victim);
+        lru_unlink(c, f);
+    }
+    c->frame_page[f] = page;
+    page_map_put(&c->where, (uint64_t)page, f);
+    lru_push_mru(c, f);
+    *frame = f;
+    return 1;
+}
+
+/* OPT state: resident frames in a max-heap on the position of their next use */
+typedef struct {
+    int n_frames;
+    int *frame_page;  // Page held by each frame, -1 if empty
+    const int *next_use; // next_use[i]: next position referencing pages[i], n_pages if none
+    int owns_next_use;   // next_use is freed by opt_free (not shared)
+    int *key;         // Next use of the page in each frame
+    int *heap;        // Frame indices, the farthest next use on top
+    int *heap_pos;    // Position of each frame in 'heap'
+    int heap_size;
+    int n_pages;
+    PageMap where;    // Resident page -> frame
+} OptCache;
+
+/**
+ * @brief Heap order: later next use first; pages never used again tie on
+ *        n_pages and go to the lower frame (the frame a forward scan finds first).
+ */
+static inline int opt_before(const OptCache* c, int a, int b) {
+    if (c->key[a] != c->key[b]) return c->key[a] > c->key[b];
+    return a < b;
+}
+
+static inline void opt_heap_set(OptCache* c, int pos, int f) {
+    c->heap[pos] = f;
+    c->heap_pos[f] = pos;
+}
+
+static inline void opt_sift_up(OptCache* c, int pos) {
+    int f = c->heap[pos];
+    while (pos > 0 && opt_before(c, f, c->heap[(pos - 1) / 2])) {
+        opt_heap_set(c, pos, c->heap[(pos - 1) / 2]);
+        pos = (pos - 1) / 2;
+    }
+    opt_heap_set(c, pos, f);
+}
+
+static inline void opt_sift_down(OptCache* c, int pos) {
+    int f = c->heap[pos];
+    int child;
+    while ((child = 2 * pos + 1) < c->heap_size) {
+        if (child + 1 < c->heap_size && opt_before(c, c->heap[child + 1], c->heap[child])) child++;
+        if (!opt_before(c, c->heap[child], f)) break;
+        opt_heap_set(c, pos, c->heap[child]);
+        pos = child;
+    }
+    opt_heap_set(c, pos, f);
+}
+
+/**
+ * @brief Computes the next use of every reference of a trace in one forward
+ *        pass with a page -> last-seen-position map: each reference fills in
+ *        the next use of the previous reference to its page.
+ *        The trace is left rewound.
+ * @return Newly allocated array of refs->count positions (count if never used again).
+ */
+static inline int* opt_next_uses(RefTrace* refs) {
+    int n_pages = (int)refs->count;
+    int page;
+    int* next_use = (int*)malloc((n_pages ? n_pages : 1) * sizeof(int));
+    PageMap seen;
+    page_map_init(&seen, refs->distinct ? refs->distinct : 1024);
+    ref_trace_rewind(refs);
+    for (int i = 0; ref_trace_next(refs, &page); i++) {
+        int earlier = page_map_get(&seen, (uint64_t)page);
+        if (earlier != -1) next_use[earlier] = i;
+        next_use[i] = n_pages;
+        page_map_put(&seen, (uint64_t)page, i);
+    }
+    page_map_free(&seen);
+    ref_trace_rewind(refs);
+    return next_use;
+}
+
+/**
+ * @brief Prepares OPT with next uses computed by opt_next_uses(). The array is
+ *        only read, so caches of several sizes can share it; it is not freed
+ *        by opt_free.
+ */
+static inline void opt_init_shared(OptCache* c, const int next_use[], int n_pages, int n_frames) {
+    c->next_use = next_use;
+    c->owns_next_use = 0;
+    c->n_frames = n_frames;
+    c->n_pages = n_pages;
+    c->frame_page = (int*)malloc(n_frames * sizeof(int));
+    c->key = (int*)malloc(n_frames * sizeof(int));
+    c->heap = (int*)malloc(n_frames * sizeof(int));
+    c->heap_pos = (int*)malloc(n_frames * sizeof(int));
+    for (int f = 0; f < n_frames; f++) c->frame_page[f] = -1;
+    c->heap_size = 0;
+    page_map_init(&c->where, n_frames);
+}
+
+/**
+ * @brief Prepares OPT over a whole trace with its own next-use array.
+ */
+static inline void opt_init_trace(OptCache* c, RefTrace* refs, int n_frames) {
+    opt_init_shared(c, opt_next_uses(refs), (int)refs->count, n_frames);
+    c->owns_next_use = 1;
+}
+
+static inline void opt_init(OptCache* c, const int pages[], int n_pages, int n_frames) {
+    RefTrace refs;
+    ref_trace_from_array(&refs, pages, n_pages);
+    opt_init_trace(c, &refs, n_frames);
+}
+
+static inline void opt_free(OptCache* c) {
+    if (c->owns_next_use) free((void*)c->next_use);
+    free(c->frame_page);
+    free(c->key);
+    free(c->heap);
+    free(c->heap_pos);
+    page_map_free(&c->where);
+}
+
+/**
+ * @brief References 'page', the i-th reference of the trace (references must
+ *        be made in order, i = 0, 1, ...).
+ *        On a fault with memory full, the page used farthest in the future
+ *        (or never again) is evicted.
+ * @param frame Receives the frame now holding the page.
+ * @param victim Receives the evicted page, -1 if nothing was evicted.
+ * @return 1 on a page fault, 0 on a hit.
+ */
+static inline int opt_reference(OptCache* c, int page, int i, int* frame, int* victim) {
+    int f = page_map_get(&c->where, (uint64_t)page);
+    *victim = -1;
+
+    if (f != -1) {
+        c->key[f] = c->next_use[i]; // Only moves later, so the frame can only rise
+        opt_sift_up(c, c->heap_pos[f]);
+        *frame = f;
+        return 0;
+    }
+
+    if (c->heap_size < c->n_frames) {
+        f = c->heap_size++;
+        c->frame_page[f] = page;
+        c->key[f] = c->next_use[i];
+        opt_heap_set(c, f, f);
+        opt_sift_up(c, f);
+    } else {
+        f = c->heap[0];
+        *victim = c->frame_page[f];
+        page_map_remove(&c->where, (uint64_t)*victim);
+        c->frame_page[f] = page;
+        c->key[f] = c->next_use[i];
+        opt_sift_down(c, 0);
+    }
+    page_map_put(&c->where, (uint64_t)page, f);
+    *frame = f;
+    return 1;
+}
+
+static inline size_t lru_metadata_bytes(const LruCache* c) {
+    return 2 * c->n_frames * sizeof(int) + page_map_bytes(&c->where);
+}
+
+static inline size_t opt_metadata_bytes(const OptCache* c) {
+    return ((size_t)c->n_pages + 3 * c->n_frames) * sizeof(int) + page_map_bytes(&c->where);
+}
+
+/* FIFO state: frames replaced in a circle, oldest first */
+typedef struct {
+    int n_frames;
+    int *frame_page;  // Page held by each frame, -1 if empty
+    int next;         // Frame holding the oldest page (the next victim)
+    PageMap where;    // Resident page -> frame
+} FifoCache;
+
+static inline void fifo_init(FifoCache* c, int n_frames) {
+    c->n_frames = n_frames;
+    c->frame_page = (int*)malloc(n_frames * sizeof(int));
+    for (int f = 0; f < n_frames; f++) c->frame_page[f] = -1;
+    c->next = 0;
+    page_map_init(&c->where, n_frames);
+}
+
+static inline void fifo_free(FifoCache* c) {
+    free(c->frame_page);
+    page_map_free(&c->where);
+}
+
+static inline int fifo_reference(FifoCache* c, int page, int* frame, int* victim) {
+    int f = page_map_get(&c->where, (uint64_t)page);
+    *victim = -1;
+    if (f != -1) {
+        *frame = f;
+        return 0;
+    }
+    f = c->next;
+    c->next = (c->next + 1) % c->n_frames;
+    if (c->frame_page[f] != -1) {
+        *victim = c->frame_page[f];
+        page_map_remove(&c->where, (uint64_t)*victim);
+    }
+    c->frame_page[f] = page;
+    page_map_put(&c->where, (uint64_t)page, f);
+    *frame = f;
+    return 1;
+}
+
+static inline size_t fifo_metadata_bytes(const FifoCache* c) {
+    return sizeof(int) + page_map_bytes(&c->where);
+}
+
+/* CLOCK (second chance): one reference bit per frame and a sweeping hand */
+typedef struct {
+    int n_frames;
+    int *frame_page;            // Page held by each frame, -1 if empty
+    unsigned char *referenced;  // Set on every use, cleared as the hand passes
+    int hand;                   // Next frame the hand looks at
+    int used;                   // Frames filled so far
+    PageMap where;              // Resident page -> frame
+} ClockCache;
+
+static inline void clock_init(ClockCache* c, int n_frames) {
+    c->n_frames = n_frames;
+    c->frame_page = (int*)malloc(n_frames * sizeof(int));
+    c->referenced = (unsigned char*)calloc(n_frames, 1);
+    for (int f = 0; f < n_frames; f++) c->frame_page[f] = -1;
+    c->hand = 0;
+    c->used = 0;
+    page_map_init(&c->where, n_frames);
+}
+
+static inline void clock_free(ClockCache* c) {
+    free(c->frame_page);
+    free(c->referenced);
+    page_map_free(&c->where);
+}
+
+/**
+ * @brief References 'page'. On a fault with memory full, the hand clears
+ *        reference bits until it reaches a frame whose bit is already clear
+ *        and evicts that page. Each bit cleared was set by an earlier
+ *        reference, so the sweep is O(1) amortized.
+ * @return 1 on a page fault, 0 on a hit.
+ */
+static inline int clock_reference(ClockCache* c, int page, int* frame, int* victim) {
+    int f = page_map_get(&c->where, (uint64_t)page);
+    *victim = -1;
+
+    if (f != -1) {
+        c->referenced[f] = 1;
+        *frame = f;
+        return 0;
+    }
+
+    if (c->used < c->n_frames) {
+        f = c->used++;
+    } else {
+        while (c->referenced[c->hand]) {
+            c->referenced[c->hand] = 0;
+            c->hand = (c->hand + 1) % c->n_frames;
+        }
+        f = c->hand;
+        c->hand = (c->hand + 1) % c->n_frames;
+        *victim = c->frame_page[f];
+        page_map_remove(&c->where, (uint64_t)*victim);
+    }
+    c->frame_page[f] = page;
+    c->referenced[f] = 1;
+    page_map_put(&c->where, (uint64_t)page, f);
+    *frame = f;
+    return 1;
+}
+
+static inline size_t clock_metadata_bytes(const ClockCache* c) {
+    return c->n_frames + sizeof(int) + page_map_bytes(&c->where);
+}
+
+/*
+ * ARC, 2Q and LIRS also remember pages that were recently evicted ("ghost"
+ * entries, no frame) to tell pages reused over a long interval from pages
+ * touched once by a scan. Their entries live in a node pool and are linked
+ * into lists through prev/next index arrays; one page -> node map covers
+ * both resident and ghost pages.
+ */
+
+/* Doubly linked list of pool nodes; head is the newest end, tail the oldest */
+typedef struct {
+    int head, tail, size;
+} NodeList;
+
+static inline void node_list_init(NodeList* l) {
+    l->head = l->tail = -1;
+    l->size = 0;
+}
+
+static inline void node_list_push(NodeList* l, int prev[], int next[], int x) {
+    prev[x] = -1;
+    next[x] = l->head;
+    if (l->head != -1) prev[l->head] = x;
+    else l->tail = x;
+    l->head = x;
+    l->size++;
+}
+
+static inline void node_list_remove(NodeList* l, int prev[], int next[], int x) {
+    if (prev[x] != -1) next[prev[x]] = next[x];
+    else l->head = next[x];
+    if (next[x] != -1) prev[next[x]] = prev[x];
+    else l->tail = prev[x];
+    l->size--;
+}
+
+/*
+ * ARC (Megiddo and Modha, FAST '03). Resident pages seen once recently are
+ * in T1, pages seen at least twice in T2; B1 and B2 hold the pages last
+ * evicted from each. A hit in B1 means T1 was too small, so the target size
+ * p of T1 grows; a hit in B2 shrinks it. Resident plus ghost pages never
+ * exceed 2 x frames.
+ */
+
+enum { ARC_T1, ARC_T2, ARC_B1, ARC_B2 };
+
+typedef struct {
+    int n_frames;
+    int *frame_page;  // Page held by each frame, -1 if empty
+    int *page;        // Node -> page
+    int *frame;       // Node -> frame, -1 for ghosts
+    int *list;        // Node -> ARC_T1 .. ARC_B2
+    int *prev, *next;
+    int *free_nodes;  // Stack of unused nodes
+    int n_free;
+    NodeList lists[4];
+    int p;            // Target size of T1
+    PageMap where;    // Page -> node, resident or ghost
+} ArcCache;
+
+static inline void arc_init(ArcCache* c, int n_frames) {
+    int nodes = 2 * n_frames;
+    c->n_frames = n_frames;
+    c->frame_page = (int*)malloc(n_frames * sizeof(int));
+    for (int f = 0; f < n_frames; f++) c->frame_page[f] = -1;
+    c->page = (int*)malloc(nodes * sizeof(int));
+    c->frame = (int*)malloc(nodes * sizeof(int));
+    c->list = (int*)malloc(nodes * sizeof(int));
+    c->prev = (int*)malloc(nodes * sizeof(int));
+    c->next = (int*)malloc(nodes * sizeof(int));
+    c->free_nodes = (int*)malloc(nodes * sizeof(int));
+    for (int i = 0; i < nodes; i++) c->free_nodes[i] = nodes - 1 - i;
+    c->n_free = nodes;
+    for (int l = 0; l < 4; l++) node_list_init(&c->lists[l]);
+    c->p = 0;
+    page_map_init(&c->where, nodes);
+}
+
+static inline void arc_free(ArcCache* c) {
+    free(c->frame_page);
+    free(c->page);
+    free(c->frame);
+    free(c->list);
+    free(c->prev);
+    free(c->next);
+    free(c->free_nodes);
+    page_map_free(&c->where);
+}
+
+static inline void arc_move(ArcCache* c, int x, int to) {
+    node_list_remove(&c->lists[c->list[x]], c->prev, c->next, x);
+    node_list_push(&c->lists[to], c->prev, c->next, x);
+    c->list[x] = to;
+}
+
+// Forgets the oldest page of a ghost list (or of T1, evicting it).
+static inline void arc_delete_lru(ArcCache* c, int from) {
+    int x = c->lists[from].tail;
+    node_list_remove(&c->lists[from], c->prev, c->next, x);
+    page_map_remove(&c->where, (uint64_t)c->page[x]);
+    c->free_nodes[c->n_free++] = x;
+}
+
+/**
+ * @brief ARC's REPLACE: evicts the LRU page of T1 into B1 if T1 is above its
+ *        target, otherwise the LRU page of T2 into B2.
+ * @return The frame freed.
+ */
+static inline int arc_replace(ArcCache* c, int hit_in_b2, int* victim) {
+    int t1 = c->lists[ARC_T1].size;
+    int from = ARC_T2, to = ARC_B2;
+    if (t1 >= 1 && ((hit_in_b2 && t1 == c->p) || t1 > c->p || c->lists[ARC_T2].size == 0)) {
+        from = ARC_T1;
+        to = ARC_B1;
+    }
+    int x = c->lists[from].tail;
+    int f = c->frame[x];
+    arc_move(c, x, to);
+    c->frame[x] = -1;
+    *victim = c->page[x];
+    return f;
+}
+
+/**
+ * @brief References 'page' following the four cases of the ARC paper.
+ * @return 1 on a page fault, 0 on a hit.
+ */
+static inline int arc_reference(ArcCache* c, int page, int* frame, int* victim) {
+    int x = page_map_get(&c->where, (uint64_t)page);
+    int t1 = c->lists[ARC_T1].size, t2 = c->lists[ARC_T2].size;
+    int b1 = c->lists[ARC_B1].size, b2 = c->lists[ARC_B2].size;
+    int f;
+    *victim = -1;
+
+    if (x != -1 && (c->list[x] == ARC_T1 || c->list[x] == ARC_T2)) {
+        arc_move(c, x, ARC_T2);
+        *frame = c->frame[x];
+        return 0;
+    }
+
+    if (x != -1) {
+        // Ghost hit: adapt p, then bring the page back straight into T2.
+        if (c->list[x] == ARC_B1) {
+            int delta = (b2 > b1) ? b2 / b1 : 1;
+            c->p = (c->p + delta < c->n_frames) ? c->p + delta : c->n_frames;
+            f = arc_replace(c, 0, victim);
+        } else {
+            int delta = (b1 > b2) ? b1 / b2 : 1;
+            c->p = (c->p - delta > 0) ? c->p - delta : 0;
+            f = arc_replace(c, 1, victim);
+        }
+        arc_move(c, x, ARC_T2);
+    } else {
+        if (t1 + b1 == c->n_frames) {
+            if (t1 < c->n_frames) {
+                arc_delete_lru(c, ARC_B1);
+                f = arc_replace(c, 0, victim);
+            } else {
+                f = c->frame[c->lists[ARC_T1].tail];
+                *victim = c->page[c->lists[ARC_T1].tail];
+                arc_delete_lru(c, ARC_T1);
+            }
+        } else if (t1 + t2 + b1 + b2 >= c->n_frames) {
+            if (t1 + t2 + b1 + b2 == 2 * c->n_frames) arc_delete_lru(c, ARC_B2);
+            f = arc_replace(c, 0, victim);
+        } else {
+            f = t1 + t2; // Still filling: ghosts only appear once memory is full
+        }
+        x = c->free_nodes[--c->n_free];
+        c->page[x] = page;
+        c->list[x] = ARC_T1;
+        node_list_push(&c->lists[ARC_T1], c->prev, c->next, x);
+        page_map_put(&c->where, (uint64_t)page, x);
+    }
+
+    c->frame[x] = f;
+    c->frame_page[f] = page;
+    *frame = f;
+    return 1;
+}
+
+static inline size_t arc_metadata_bytes(const ArcCache* c) {
+    return 2 * c->n_frames * 6 * sizeof(int) + page_map_bytes(&c->where);
+}
+
+/*
+ * 2Q (Johnson and Shasha, VLDB '94), full version. New pages enter A1in, a
+ * FIFO holding about a quarter of the frames; pages evicted from it are
+ * remembered in the ghost FIFO A1out (half the frame count). Only a page
+ * referenced again while in A1out is promoted to Am, an LRU list, so a scan
+ * of pages used once never displaces the hot set in Am.
+ */
+
+enum { TWOQ_AM, TWOQ_A1IN, TWOQ_A1OUT };
+
+typedef struct {
+    int n_frames;
+    int k_in;         // Target size of A1in
+    int k_out;        // Capacity of A1out
+    int *frame_page;  // Page held by each frame, -1 if empty
+    int *page;        // Node -> page
+    int *frame;       // Node -> frame, -1 for ghosts
+    int *list;        // Node -> TWOQ_AM .. TWOQ_A1OUT
+    int *prev, *next;
+    int *free_nodes;
+    int n_free;
+    int used;         // Frames filled so far
+    NodeList lists[3];
+    PageMap where;    // Page -> node, resident or ghost
+} TwoQCache;
+
+static inline void twoq_init(TwoQCache* c, int n_frames) {
+    c->n_frames = n_frames;
+    c->k_in = (n_frames / 4 > 1) ? n_frames / 4 : 1;
+    c->k_out = (n_frames / 2 > 1) ? n_frames / 2 : 1;
+    int nodes = n_frames + c->k_out + 1;
+    c->frame_page = (int*)malloc(n_frames * sizeof(int));
+    for (int f = 0; f < n_frames; f++) c->frame_page[f] = -1;
+    c->page = (int*)malloc(nodes * sizeof(int));
+    c->frame = (int*)malloc(nodes * sizeof(int));
+    c->list = (int*)malloc(nodes * sizeof(int));
+    c->prev = (int*)malloc(nodes * sizeof(int));
+    c->next = (int*)malloc(nodes * sizeof(int));
+    c->free_nodes = (int*)malloc(nodes * sizeof(int));
+    for (int i = 0; i < nodes; i++) c->free_nodes[i] = nodes - 1 - i;
+    c->n_free = nodes;
+    c->used = 0;
+    for (int l = 0; l < 3; l++) node_list_init(&c->lists[l]);
+    page_map_init(&c->where, nodes);
+}
+
+static inline void twoq_free(TwoQCache* c) {
+    free(c->frame_page);
+    free(c->page);
+    free(c->frame);
+    free(c->list);
+    free(c->prev);
+    free(c->next);
+    free(c->free_nodes);
+    page_map_free(&c->where);
+}
+
+/**
+ * @brief Frees a frame: the oldest A1in page moves to A1out while A1in is over
+ *        its target (or Am is empty), otherwise the LRU page of Am is dropped.
+ */
+static inline int twoq_reclaim(TwoQCache* c, int* victim) {
+    if (c->used < c->n_frames) return c->used++;
+
+    NodeList* in = &c->lists[TWOQ_A1IN];
+    NodeList* out = &c->lists[TWOQ_A1OUT];
+    int x, f;
+    if (in->size > c->k_in || c->lists[TWOQ_AM].size == 0) {
+        x = in->tail;
+        f = c->frame[x];
+        node_list_remove(in, c->prev, c->next, x);
+        node_list_push(out, c->prev, c->next, x);
+        c->list[x] = TWOQ_A1OUT;
+        c->frame[x] = -1;
+        *victim = c->page[x];
+        if (out->size > c->k_out) {
+            int y = out->tail;
+            node_list_remove(out, c->prev, c->next, y);
+            page_map_remove(&c->where, (uint64_t)c->page[y]);
+            c->free_nodes[c->n_free++] = y;
+        }
+    } else {
+        x = c->lists[TWOQ_AM].tail;
+        f = c->frame[x];
+        node_list_remove(&c->lists[TWOQ_AM], c->prev, c->next, x);
+        page_map_remove(&c->where, (uint64_t)c->page[x]);
+        c->free_nodes[c->n_free++] = x;
+        *victim = c->page[x];
+    }
+    return f;
+}
+
+/**
+ * @brief References 'page': hits in Am move to its MRU end, hits in A1in
+ *        change nothing, a miss remembered in A1out loads the page into Am and
+ *        any other miss loads it into A1in.
+ * @return 1 on a page fault, 0 on a hit.
+ */
+static inline int twoq_reference(TwoQCache* c, int page, int* frame, int* victim) {
+    int x = page_map_get(&c->where, (uint64_t)page);
+    *victim = -1;
+
+    if (x != -1 && c->list[x] != TWOQ_A1OUT) {
+        if (c->list[x] == TWOQ_AM) {
+            node_list_remove(&c->lists[TWOQ_AM], c->prev, c->next, x);
+            node_list_push(&c->lists[TWOQ_AM], c->prev, c->next, x);
+        }
+        *frame = c->frame[x];
+        return 0;
+    }
+
+    if (x != -1) {
+        // Unlink first so reclaiming cannot push this very page out of A1out.
+        node_list_remove(&c->lists[TWOQ_A1OUT], c->prev, c->next, x);
+        c->frame[x] = twoq_reclaim(c, victim);
+        c->list[x] = TWOQ_AM;
+        node_list_push(&c->lists[TWOQ_AM], c->prev, c->next, x);
+    } else {
+        int f = twoq_reclaim(c, victim);
+        x = c->free_nodes[--c->n_free];
+        c->page[x] = page;
+        c->frame[x] = f;
+        c->list[x] = TWOQ_A1IN;
+        node_list_push(&c->lists[TWOQ_A1IN], c->prev, c->next, x);
+        page_map_put(&c->where, (uint64_t)page, x);
+    }
+    c->frame_page[c->frame[x]] = page;
+    *frame = c->frame[x];
+    return 1;
+}
+
+static inline size_t twoq_metadata_bytes(const TwoQCache* c) {
+    return (size_t)(c->n_frames + c->k_out + 1) * 6 * sizeof(int) + page_map_bytes(&c->where);
+}
+
+/*
+ * LIRS (Jiang and Zhang, SIGMETRICS '02). Pages are ranked by inter-reference
+ * recency (IRR): the number of distinct pages used between their last two
+ * references. Pages with a low IRR (LIR) keep most of the frames; the rest
+ * (1%, at least one frame) hold high-IRR (HIR) pages in the FIFO queue Q,
+ * whose front is the next victim. The recency stack S holds LIR pages plus
+ * recently seen HIR pages, resident or not; an HIR page referenced while
+ * still in S has a smaller IRR than the oldest LIR page and swaps status
+ * with it. S is pruned so that its bottom is always an LIR page.
+ *
+ * Evicted HIR pages stay in S as non-resident entries. The paper lets them
+ * accumulate; here at most n_frames are kept (the oldest dropped first, via
+ * the ghost list G) so memory stays bounded.
+ */
+
+enum { LIRS_LIR, LIRS_HIR, LIRS_NONRESIDENT };
+
+typedef struct {
+    int n_frames;
+    int lir_limit;           // Frames for LIR pages
+    int lir_count;
+    int *frame_page;         // Page held by each frame, -1 if empty
+    int *page;               // Node -> page
+    int *frame;              // Node -> frame, -1 when not resident
+    int *status;             // Node -> LIRS_LIR .. LIRS_NONRESIDENT
+    unsigned char *in_stack; // Node is in S
+    int *s_prev, *s_next;    // Links in S (head = top, most recent)
+    int *q_prev, *q_next;    // Links in Q for resident HIR nodes, in G for non-resident ones
+    int *free_nodes;
+    int n_free;
+    int used;                // Frames filled so far
+    NodeList stack;          // S
+    NodeList queue;          // Q: head = newest, tail = next victim
+    NodeList ghosts;         // G: non-resident entries of S, oldest at the tail
+    PageMap where;           // Page -> node
+} LirsCache;
+
+static inline void lirs_init(LirsCache* c, int n_frames) {
+    int nodes = 2 * n_frames + 2;
+    int hir = (n_frames / 100 > 1) ? n_frames / 100 : 1;
+    c->n_frames = n_frames;
+    c->lir_limit = n_frames - hir;
+    c->lir_count = 0;
+    c->frame_page = (int*)malloc(n_frames * sizeof(int));
+    for (int f = 0; f < n_frames; f++) c->frame_page[f] = -1;
+    c->page = (int*)malloc(nodes * sizeof(int));
+    c->frame = (int*)malloc(nodes * sizeof(int));
+    c->status = (int*)malloc(nodes * sizeof(int));
+    c->in_stack = (unsigned char*)malloc(nodes);
+    c->s_prev = (int*)malloc(nodes * sizeof(int));
+    c->s_next = (int*)malloc(nodes * sizeof(int));
+    c->q_prev = (int*)malloc(nodes * sizeof(int));
+    c->q_next = (int*)malloc(nodes * sizeof(int));
+    c->free_nodes = (int*)malloc(nodes * sizeof(int));
+    for (int i = 0; i < nodes; i++) c->free_nodes[i] = nodes - 1 - i;
+    c->n_free = nodes;
+    c->used = 0;
+    node_list_init(&c->stack);
+    node_list_init(&c->queue);
+    node_list_init(&c->ghosts);
+    page_map_init(&c->where, nodes);
+}
+
+static inline void lirs_free(LirsCache* c) {
+    free(c->frame_page);
+    free(c->page);
+    free(c->frame);
+    free(c->status);
+    free(c->in_stack);
+    free(c->s_prev);
+    free(c->s_next);
+    free(c->q_prev);
+    free(c->q_next);
+    free(c->free_nodes);
+    page_map_free(&c->where);
+}
+
+static inline void lirs_forget(LirsCache* c, int x) {
+    page_map_remove(&c->where, (uint64_t)c->page[x]);
+    c->free_nodes[c->n_free++] = x;
+}
+
+static inline void lirs_stack_remove(LirsCache* c, int x) {
+    node_list_remove(&c->stack, c->s_prev, c->s_next, x);
+    c->in_stack[x] = 0;
+}
+
+// Moves x to the top of S.
+static inline void lirs_stack_top(LirsCache* c, int x) {
+    if (c->in_stack[x]) node_list_remove(&c->stack, c->s_prev, c->s_next, x);
+    node_list_push(&c->stack, c->s_prev, c->s_next, x);
+    c->in_stack[x] = 1;
+}
+
+// Pops HIR entries off the bottom of S until an LIR page is at the bottom.
+static inline void lirs_prune(LirsCache* c) {
+    int x;
+    while ((x = c->stack.tail) != -1 && c->status[x] != LIRS_LIR) {
+        lirs_stack_remove(c, x);
+        if (c->status[x] == LIRS_NONRESIDENT) {
+            node_list_remove(&c->ghosts, c->q_prev, c->q_next, x);
+            lirs_forget(c, x);
+        }
+    }
+}
+
+// Turns the LIR page at the bottom of S into a resident HIR page at the end of Q.
+static inline void lirs_demote_bottom(LirsCache* c) {
+    int y = c->stack.tail;
+    lirs_stack_remove(c, y);
+    c->status[y] = LIRS_HIR;
+    node_list_push(&c->queue, c->q_prev, c->q_next, y);
+    lirs_prune(c);
+}
+
+/**
+ * @brief Frees a frame for a missing page, evicting the resident HIR page at
+ *        the front of Q once memory is full.
+ */
+static inline int lirs_reclaim(LirsCache* c, int* victim) {
+    if (c->used < c->n_frames) return c->used++;
+
+    int y = c->queue.tail;
+    int f = c->frame[y];
+    node_list_remove(&c->queue, c->q_prev, c->q_next, y);
+    *victim = c->page[y];
+    c->frame[y] = -1;
+    if (!c->in_stack[y]) {
+        lirs_forget(c, y);
+        return f;
+    }
+    c->status[y] = LIRS_NONRESIDENT;
+    node_list_push(&c->ghosts, c->q_prev, c->q_next, y);
+    if (c->ghosts.size > c->n_frames) {
+        int old = c->ghosts.tail;
+        node_list_remove(&c->ghosts, c->q_prev, c->q_next, old);
+        lirs_stack_remove(c, old);
+        lirs_forget(c, old);
+    }
+    return f;
+}
+
+/**
+ * @brief References 'page' following the LIRS cases: LIR hit, resident HIR
+ *        hit (in S or not) and miss (remembered in S or not).
+ * @return 1 on a page fault, 0 on a hit.
+ */
+static inline int lirs_reference(LirsCache* c, int page, int* frame, int* victim) {
+    int x = page_map_get(&c->where, (uint64_t)page);
+    *victim = -1;
+
+    if (x != -1 && c->status[x] == LIRS_LIR) {
+        lirs_stack_top(c, x);
+        lirs_prune(c);
+        *frame = c->frame[x];
+        return 0;
+    }
+
+    if (x != -1 && c->status[x] == LIRS_HIR) {
+        node_list_remove(&c->queue, c->q_prev, c->q_next, x);
+        if (c->in_stack[x]) {
+            lirs_stack_top(c, x);
+            c->status[x] = LIRS_LIR;
+            lirs_demote_bottom(c);
+        } else {
+            lirs_stack_top(c, x);
+            node_list_push(&c->queue, c->q_prev, c->q_next, x);
+        }
+        *frame = c->frame[x];
+        return 0;
+    }
+
+    if (x != -1) {
+        // Non-resident entry still in S: its IRR beats the oldest LIR page.
+        node_list_remove(&c->ghosts, c->q_prev, c->q_next, x);
+        c->frame[x] = lirs_reclaim(c, victim);
+        lirs_stack_top(c, x);
+        c->status[x] = LIRS_LIR;
+        lirs_demote_bottom(c);
+    } else {
+        int f = lirs_reclaim(c, victim);
+        x = c->free_nodes[--c->n_free];
+        c->page[x] = page;
+        c->frame[x] = f;
+        c->in_stack[x] = 0;
+        page_map_put(&c->where, (uint64_t)page, x);
+        lirs_stack_top(c, x);
+        if (c->lir_count < c->lir_limit) {
+            c->status[x] = LIRS_LIR; // Warm-up: the first pages fill the LIR set
+            c->lir_count++;
+        } else {
+            c->status[x] = LIRS_HIR;
+            node_list_push(&c->queue, c->q_prev, c->q_next, x);
+            lirs_prune(c);
+        }
+    }
+    c->frame_page[c->frame[x]] = page;
+    *frame = c->frame[x];
+    return 1;
+}
+
+static inline size_t lirs_metadata_bytes(const LirsCache* c) {
+    return (size_t)(2 * c->n_frames + 2) * (8 * sizeof(int) + 1) + page_map_bytes(&c->where);
+}
+
+/*
+ * Mattson stack distances. Under LRU, a reference hits with F frames exactly
+ * when fewer than F distinct pages were referenced since the previous use of
+ * the same page. That count is kept with a Fenwick tree over reference
+ * positions in which only the latest position of each page is marked: the
+ * distance is the number of marks after the page's previous position.
+ */
+
+static inline void fenwick_add(int tree[], int size, int pos, int delta) {
+    for (pos++; pos <= size; pos += pos & -pos) tree[pos] += delta;
+}
+
+// Sum of marks at positions 0..pos-1
+static inline int fenwick_prefix(const int tree[], int pos) {
+    int sum = 0;
+    for (; pos > 0; pos -= pos & -pos) sum += tree[pos];
+    return sum;
+}
+
+/**
+ * @brief Computes the LRU stack distance of every reference in O(log n) each.
+ *        The trace is replayed from the start and left rewound.
+ * @param hist Receives hist[d] = number of re-references at stack distance d
+ *        (1 = the most recently used page); needs refs->count + 1 zeroed entries.
+ * @param distinct Receives the number of distinct pages.
+ * @return Number of cold misses (first references), which fault at any size.
+ */
+static inline long long lru_stack_distances(RefTrace* refs, long long hist[], int* distinct) {
+    int n_pages = (int)refs->count;
+    int* tree = (int*)calloc(n_pages + 1, sizeof(int));
+    long long cold = 0;
+    int marked = 0, page;
+    PageMap last;
+    page_map_init(&last, refs->distinct ? refs->distinct : 1024);
+
+    ref_trace_rewind(refs);
+    for (int i = 0; ref_trace_next(refs, &page); i++) {
+        int prev = page_map_get(&last, (uint64_t)page);
+        if (prev == -1) {
+            cold++;
+            marked++;
+        } else {
+            // Distinct pages used after 'prev', plus the page itself.
+            hist[marked - fenwick_prefix(tree, prev + 1) + 1]++;
+            fenwick_add(tree, n_pages, prev, -1);
+        }
+        fenwick_add(tree, n_pages, i, 1);
+        page_map_put(&last, (uint64_t)page, i);
+    }
+    ref_trace_rewind(refs);
+
+    *distinct = marked;
+    page_map_free(&last);
+    free(tree);
+    return cold;
+}
+
+/*
+ * Fixed-size SHARDS (Waldspurger et al., FAST '15). A page is sampled when
+ * hash(page) mod SHARDS_MODULUS is below a threshold T, so either every
+ * reference to a page is seen or none is, and the sampling rate is
+ * R = T / SHARDS_MODULUS. Stack distances measured among sampled pages are
+ * scaled by 1/R. At most max_pages sampled pages are tracked: when one more
+ * arrives, the page with the largest hash is dropped and T falls to that
+ * hash. Each reference is weighted by 1/R at the time it was sampled, which
+ * is the same as rescaling the histogram whenever R drops.
+ *
+ * A few hot pages falling in or out of the sample skew the weighted total
+ * away from the true reference count. Following the paper's SHARDS_adj,
+ * shards_adjust() puts the difference into the smallest distance bucket.
+ *
+ * The Fenwick tree runs over sample timestamps and is compacted (timestamps
+ * renumbered in order) whenever it fills, so it stays at 2 x max_pages.
+ */
+
+#define SHARDS_MODULUS (1ULL << 24)
+
+typedef struct {
+    int max_pages;        // Sampled pages tracked at once (the memory budget)
+    int max_frames;       // Largest frame count of the curve
+    uint64_t threshold;   // Sample pages whose hash is below this
+    PageMap last;         // Sampled page -> timestamp of its latest reference
+    int *tree;            // Fenwick tree marking the latest timestamp of each sampled page
+    int tree_size;
+    int clock;            // Next timestamp
+    int marked;           // Sampled pages currently tracked
+    uint64_t *heap_hash;  // Tracked pages in a max-heap on hash, to find the next to drop
+    int *heap_page;
+    int heap_size;
+    double *hist;         // hist[d]: weighted references at scaled distance d; [max_frames + 1] = beyond/cold
+    double total;         // Weighted sampled references
+    long long sampled;    // Sampled references (unweighted)
+    long long references; // All references seen
+} ShardsSampler;
+
+static inline uint64_t shards_hash(int page) {
+    return page_map_hash((uint64_t)page) & (SHARDS_MODULUS - 1);
+}
+
+static inline void shards_init(ShardsSampler* s, int max_pages, int max_frames) {
+    s->max_pages = max_pages;
+    s->max_frames = max_frames;
+    s->threshold = SHARDS_MODULUS;
+    page_map_init(&s->last, max_pages + 1);
+    s->tree_size = 2 * max_pages + 2;
+    s->tree = (int*)calloc(s->tree_size + 1, sizeof(int));
+    s->clock = 0;
+    s->marked = 0;
+    s->heap_hash = (uint64_t*)malloc((max_pages + 1) * sizeof(uint64_t));
+    s->heap_page = (int*)malloc((max_pages + 1) * sizeof(int));
+    s->heap_size = 0;
+    s->hist = (double*)calloc(max_frames + 2, sizeof(double));
+    s->total = 0;
+    s->sampled = 0;
+    s->references = 0;
+}
+
+static inline void shards_free(ShardsSampler* s) {
+    page_map_free(&s->last);
+    free(s->tree);
+    free(s->heap_hash);
+    free(s->heap_page);
+    free(s->hist);
+}
+
+static inline void shards_heap_push(ShardsSampler* s, uint64_t hash, int page) {
+    int pos = s->heap_size++;
+    while (pos > 0 && s->heap_hash[(pos - 1) / 2] < hash) {
+        s->heap_hash[pos] = s->heap_hash[(pos - 1) / 2];
+        s->heap_page[pos] = s->heap_page[(pos - 1) / 2];
+        pos = (pos - 1) / 2;
+    }
+    s->heap_hash[pos] = hash;
+    s->heap_page[pos] = page;
+}
+
+static inline void shards_heap_pop(ShardsSampler* s) {
+    uint64_t hash = s->heap_hash[--s->heap_size];
+    int page = s->heap_page[s->heap_size];
+    int pos = 0, child;
+    while ((child = 2 * pos + 1) < s->heap_size) {
+        if (child + 1 < s->heap_size && s->heap_hash[child + 1] > s->heap_hash[child]) child++;
+        if (s->heap_hash[child] <= hash) break;
+        s->heap_hash[pos] = s->heap_hash[child];
+        s->heap_page[pos] = s->heap_page[child];
+        pos = child;
+    }
+    if (s->heap_size > 0) {
+        s->heap_hash[pos] = hash;
+        s->heap_page[pos] = page;
+    }
+}
+
+// qsort comparison for (timestamp, page) pairs
+static inline int shards_compare_stamp(const void* a, const void* b) {
+    int x = ((const int*)a)[0], y = ((const int*)b)[0];
+    return (x > y) - (x < y);
+}
+
+// Renumbers the tracked timestamps 0..marked-1 in order and rebuilds the tree.
+static inline void shards_compact(ShardsSampler* s) {
+    int* pairs = (int*)malloc(2 * (s->marked ? s->marked : 1) * sizeof(int));
+    int k = 0;
+    for (size_t i = 0; i < s->last.capacity; i++) {
+        if (!s->last.used[i]) continue;
+        pairs[2 * k] = s->last.values[i];
+        pairs[2 * k + 1] = (int)s->last.keys[i];
+        k++;
+    }
+    qsort(pairs, k, 2 * sizeof(int), shards_compare_stamp);
+    memset(s->tree, 0, (s->tree_size + 1) * sizeof(int));
+    for (int r = 0; r < k; r++) {
+        page_map_put(&s->last, (uint64_t)pairs[2 * r + 1], r);
+        fenwick_add(s->tree, s->tree_size, r, 1);
+    }
+    s->clock = k;
+    free(pairs);
+}
+
+/**
+ * @brief Feeds one reference to the sampler; O(log max_pages) if sampled, O(1) if not.
+ */
+static inline void shards_reference(ShardsSampler* s, int page) {
+    uint64_t hash = shards_hash(page);
+    s->references++;
+    if (hash >= s->threshold) return;
+
+    double rate = (double)s->threshold / SHARDS_MODULUS;
+    int bucket = s->max_frames + 1;
+    int prev = page_map_get(&s->last, (uint64_t)page);
+    s->sampled++;
+    s->total += 1.0 / rate;
+
+    if (s->clock == s->tree_size) {
+        shards_compact(s);
+        prev = page_map_get(&s->last, (uint64_t)page);
+    }
+
+    if (prev != -1) {
+        int distance = s->marked - fenwick_prefix(s->tree, prev + 1) + 1;
+        double scaled = distance / rate;
+        if (scaled <= s->max_frames) bucket = (int)(scaled + 0.5);
+        if (bucket < 1) bucket = 1;
+        fenwick_add(s->tree, s->tree_size, prev, -1);
+    } else {
+        s->marked++;
+        shards_heap_push(s, hash, page);
+    }
+    s->hist[bucket] += 1.0 / rate;
+    fenwick_add(s->tree, s->tree_size, s->clock, 1);
+    page_map_put(&s->last, (uint64_t)page, s->clock++);
+
+    // Over budget: stop sampling the page with the largest hash and everything above it.
+    if (s->marked > s->max_pages) {
+        int dropped = s->heap_page[0];
+        s->threshold = s->heap_hash[0];
+        shards_heap_pop(s);
+        fenwick_add(s->tree, s->tree_size, page_map_get(&s->last, (uint64_t)dropped), -1);
+        page_map_remove(&s->last, (uint64_t)dropped);
+        s->marked--;
+    }
+}
+
+/**
+ * @brief SHARDS_adj: moves the gap between the references seen and the weighted
+ *        sampled total into distance 1, so the curve is normalized by the true
+ *        reference count. Call once, after the last reference.
+ */
+static inline void shards_adjust(ShardsSampler* s) {
+    if (s->max_frames >= 1) s->hist[1] += s->references - s->total;
+    s->total = (double)s->references;
+}
+
+/*
+ * Several processes sharing one pool of frames. Each frame's page belongs to
+ * a partition (a process) and sits on two recency lists: its partition's and
+ * one across all partitions. Global replacement evicts the least recently
+ * used page in memory; local replacement evicts within the faulting
+ * partition once it holds its allocation, and otherwise takes a frame from a
+ * partition holding more than its own allocation (partitions whose
+ * allocation was cut give their frames back lazily, one fault at a time).
+ * If memory is full and no partition is over its allocation, the allocations
+ * add up to more than memory and the global LRU page is taken. Partitions
+ * over their allocation are kept on a list, so every reference is O(1).
+ */
+
+typedef struct {
+    int n_frames;
+    int n_parts;
+    int global;       // Replace the globally LRU page regardless of allocations
+    int *frame_page;  // Page held by each frame, -1 if empty
+    int *owner;       // Partition of the page in each frame
+    int *prev, *next;   // Frame recency within its partition
+    int *gprev, *gnext; // Frame recency across all partitions
+    NodeList *local;  // Per partition, head = most recently used
+    NodeList all;
+    int *alloc;       // Frames each partition is allotted
+    long long total_alloc;
+    int *over_prev, *over_next; // Partitions holding more than their allocation
+    int *is_over;
+    NodeList over;
+    int *free_frames; // Stack of empty frames, lowest index on top
+    int n_free;
+    PageMap where;    // Resident page -> frame
+} PartitionCache;
+
+static inline void partition_init(PartitionCache* c, int n_frames, int n_parts, int global) {
+    c->n_frames = n_frames;
+    c->n_parts = n_parts;
+    c->global = global;
+    c->frame_page = (int*)malloc(n_frames * sizeof(int));
+    c->owner = (int*)malloc(n_frames * sizeof(int));
+    c->prev = (int*)malloc(n_frames * sizeof(int));
+    c->next = (int*)malloc(n_frames * sizeof(int));
+    c->gprev = (int*)malloc(n_frames * sizeof(int));
+    c->gnext = (int*)malloc(n_frames * sizeof(int));
+    c->free_frames = (int*)malloc(n_frames * sizeof(int));
+    for (int f = 0; f < n_frames; f++) {
+        c->frame_page[f] = -1;
+        c->free_frames[f] = n_frames - 1 - f;
+    }
+    c->n_free = n_frames;
+    c->local = (NodeList*)malloc(n_parts * sizeof(NodeList));
+    c->alloc = (int*)calloc(n_parts, sizeof(int));
+    c->over_prev = (int*)malloc(n_parts * sizeof(int));
+    c->over_next = (int*)malloc(n_parts * sizeof(int));
+    c->is_over = (int*)calloc(n_parts, sizeof(int));
+    for (int p = 0; p < n_parts; p++) node_list_init(&c->local[p]);
+    node_list_init(&c->all);
+    node_list_init(&c->over);
+    c->total_alloc = 0;
+    page_map_init(&c->where, n_frames);
+}
+
+static inline void partition_free(PartitionCache* c) {
+    free(c->frame_page);
+    free(c->owner);
+    free(c->prev);
+    free(c->next);
+    free(c->gprev);
+    free(c->gnext);
+    free(c->free_frames);
+    free(c->local);
+    free(c->alloc);
+    free(c->over_prev);
+    free(c->over_next);
+    free(c->is_over);
+    page_map_free(&c->where);
+}
+
+// Keeps partition p on the over-allocation list exactly while it holds more than its allocation.
+static inline void partition_check_over(PartitionCache* c, int p) {
+    int over = c->local[p].size > c->alloc[p];
+    if (over && !c->is_over[p]) node_list_push(&c->over, c->over_prev, c->over_next, p);
+    else if (!over && c->is_over[p]) node_list_remove(&c->over, c->over_prev, c->over_next, p);
+    c->is_over[p] = over;
+}
+
+/**
+ * @brief Sets how many frames partition p is allotted. Frames above a cut
+ *        allocation are reclaimed lazily by other partitions' faults.
+ */
+static inline void partition_set_alloc(PartitionCache* c, int p, int frames) {
+    c->total_alloc += frames - c->alloc[p];
+    c->alloc[p] = frames;
+    partition_check_over(c, p);
+}
+
+// Empties frame f, returning the page it held.
+static inline int partition_evict(PartitionCache* c, int f) {
+    int p = c->owner[f], page = c->frame_page[f];
+    node_list_remove(&c->local[p], c->prev, c->next, f);
+    node_list_remove(&c->all, c->gprev, c->gnext, f);
+    page_map_remove(&c->where, (uint64_t)page);
+    c->frame_page[f] = -1;
+    partition_check_over(c, p);
+    return page;
+}
+
+/**
+ * @brief Releases 'page' (e.g. it left its working set) if it is resident.
+ * @return 1 if a frame was freed.
+ */
+static inline int partition_drop(PartitionCache* c, int page) {
+    int f = page_map_get(&c->where, (uint64_t)page);
+    if (f == -1) return 0;
+    partition_evict(c, f);
+    c->free_frames[c->n_free++] = f;
+    return 1;
+}
+
+/**
+ * @brief Partition 'part' references 'page' (page numbers must be unique
+ *        across partitions). A hit refreshes both recency lists; a fault
+ *        takes an empty frame or evicts as described above.
+ * @param victim Receives the evicted page, -1 if nothing was evicted.
+ * @return 1 on a page fault, 0 on a hit.
+ */
+static inline int partition_reference(PartitionCache* c, int part, int page, int* frame, int* victim) {
+    int f = page_map_get(&c->where, (uint64_t)page);
+    *victim = -1;
+
+    if (f != -1) {
+        node_list_remove(&c->local[part], c->prev, c->next, f);
+        node_list_push(&c->local[part], c->prev, c->next, f);
+        node_list_remove(&c->all, c->gprev, c->gnext, f);
+        node_list_push(&c->all, c->gprev, c->gnext, f);
+        *frame = f;
+        return 0;
+    }
+
+    if (c->n_free > 0) f = c->free_frames[--c->n_free];
+    else if (c->global) f = c->all.tail;
+    else if (c->local[part].size > 0 && c->local[part].size >= c->alloc[part]) f = c->local[part].tail;
+    else if (c->over.size > 0) f = c->local[c->over.tail].tail;
+    else f = c->all.tail; // Allocations exceed memory
+    if (c->frame_page[f] != -1) *victim = partition_evict(c, f);
+
+    c->frame_page[f] = page;
+    c->owner[f] = part;
+    node_list_push(&c->local[part], c->prev, c->next, f);
+    node_list_push(&c->all, c->gprev, c->gnext, f);
+    page_map_put(&c->where, (uint64_t)page, f);
+    partition_check_over(c, part);
+    *frame = f;
+    return 1;
+}
+
+/*
+ * Working sets (Denning): a process's working set is the set of distinct
+ * pages among its last 'window' references, in its own virtual time. Each
+ * process keeps a ring of those references and each page a count of its
+ * occurrences in the ring, so sliding the window is O(1).
+ */
+
+typedef struct {
+    int window;
+    int *ring;        // window entries per process
+    int *ring_pos;    // Next slot to overwrite, per process
+    long long *seen;  // References made by each process so far
+    int *count;       // Occurrences of each page in its process's window
+    int *size;        // Working set size per process
+} WorkingSet;
+
+/**
+ * @brief Prepares working sets for 'n_procs' processes over pages 0..n_pages-1.
+ */
+static inline void ws_init(WorkingSet* w, int n_procs, int n_pages, int window) {
+    w->window = window;
+    w->ring = (int*)malloc((size_t)n_procs * window * sizeof(int));
+    w->ring_pos = (int*)calloc(n_procs, sizeof(int));
+    w->seen = (long long*)calloc(n_procs, sizeof(long long));
+    w->count = (int*)calloc(n_pages, sizeof(int));
+    w->size = (int*)calloc(n_procs, sizeof(int));
+}
+
+static inline void ws_free(WorkingSet* w) {
+    free(w->ring);
+    free(w->ring_pos);
+    free(w->seen);
+    free(w->count);
+    free(w->size);
+}
+
+/**
+ * @brief Process 'proc' references 'page', sliding its window by one.
+ * @return The page that left the working set, or -1.
+ */
+static inline int ws_reference(WorkingSet* w, int proc, int page) {
+    int* slot = &w->ring[(size_t)proc * w->window + w->ring_pos[proc]];
+    int left = -1;
+
+    if (w->seen[proc]++ >= w->window) {
+        int old = *slot;
+        if (--w->count[old] == 0) {
+            w->size[proc]--;
+            left = old;
+        }
+    }
+    *slot = page;
+    if (w->count[page]++ == 0) {
+        w->size[proc]++;
+        if (left == page) left = -1; // Dropped and re-entered in the same step
+    }
+    w->ring_pos[proc] = (w->ring_pos[proc] + 1) % w->window;
+    return left;
+}
+
+#endif // REPLACEMENT_H
@@ -0,0 +1,180 @@
+/*
+ * tlb_sim.h
+ * =========
+ * Address translation in front of the page replacement engines: a
+ * set-associative TLB and an x86-64 style 4-level radix page table, with
+ * either 4KB pages or 2MB huge pages.
+ *
+ * - Tlb: 'sets' x 'ways' entries, indexed by the low bits of the page number,
+ *   least recently used way replaced within a set. Entries are tagged with
+ *   the page size, so 4KB and 2MB translations never alias.
+ * - PageTable: PML4 -> PDPT -> PD -> PT, 9 index bits per level over a 4KB
+ *   virtual page number (48-bit addresses). A 4KB translation reads one entry
+ *   per level (4 memory references); a 2MB mapping ends at the PD (3). A walk
+ *   stops early at the first level with no entry, as a real walker does for
+ *   an address that was never mapped. Table nodes are allocated on first use
+ *   and never freed, so n_nodes x 4KB is the page table's memory footprint.
+ *
+ * Every function is static inline so each simulator can include this header
+ * directly and still be compiled on its own.
+ */
+
+#ifndef TLB_SIM_H
+#define TLB_SIM_H
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#define PT_LEVELS 4
+#define PT_INDEX_BITS 9
+#define PT_ENTRIES (1 << PT_INDEX_BITS)
+#define PT_NODE_BYTES 4096           // One 512-entry table of 8-byte entries
+#define HUGE_PAGE_SHIFT PT_INDEX_BITS // 2MB = 512 x 4KB
+
+#define PT_ABSENT -1   // No entry: the walk stops here
+#define PT_SWAPPED -2  // Leaf that was mapped but is not resident
+
+/* Set-associative TLB with per-set LRU */
+typedef struct {
+    int sets;
+    int ways;
+    uint64_t *tags;    // (page number << 1) | huge, per way
+    uint64_t *stamp;   // Last use of each way, 0 if invalid
+    uint64_t clock;
+} Tlb;
+
+static inline void tlb_init(Tlb* t, int sets, int ways) {
+    t->sets = sets;
+    t->ways = ways;
+    t->tags = (uint64_t*)calloc((size_t)sets * ways, sizeof(uint64_t));
+    t->stamp = (uint64_t*)calloc((size_t)sets * ways, sizeof(uint64_t));
+    t->clock = 0;
+}
+
+static inline void tlb_free(Tlb* t) {
+    free(t->tags);
+    free(t->stamp);
+}
+
+static inline uint64_t tlb_tag(uint64_t page, int huge) {
+    return (page << 1) | (uint64_t)(huge != 0);
+}
+
+// First way of the set 'page' maps to.
+static inline size_t tlb_set(const Tlb* t, uint64_t page) {
+    return (size_t)(page % (uint64_t)t->sets) * t->ways;
+}
+
+/**
+ * @brief Looks up a translation and marks it most recently used.
+ * @return 1 on a TLB hit, 0 on a miss.
+ */
+static inline int tlb_lookup(Tlb* t, uint64_t page, int huge) {
+    uint64_t tag = tlb_tag(page, huge);
+    size_t base = tlb_set(t, page);
+    for (int w = 0; w < t->ways; w++) {
+        if (t->stamp[base + w] != 0 && t->tags[base + w] == tag) {
+            t->stamp[base + w] = ++t->clock;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Installs a translation, replacing an invalid or the least recently used way.
+ */
+static inline void tlb_insert(Tlb* t, uint64_t page, int huge) {
+    size_t base = tlb_set(t, page), victim = base;
+    for (int w = 0; w < t->ways; w++) {
+        if (t->stamp[base + w] < t->stamp[victim]) victim = base + w;
+    }
+    t->tags[victim] = tlb_tag(page, huge);
+    t->stamp[victim] = ++t->clock;
+}
+
+/**
+ * @brief Drops a translation (TLB shootdown after its page was evicted).
+ */
+static inline void tlb_invalidate(Tlb* t, uint64_t page, int huge) {
+    uint64_t tag = tlb_tag(page, huge);
+    size_t base = tlb_set(t, page);
+    for (int w = 0; w < t->ways; w++) {
+        if (t->stamp[base + w] != 0 && t->tags[base + w] == tag) t->stamp[base + w] = 0;
+    }
+}
+
+/* 4-level radix page table; node 0 is the PML4 */
+typedef struct {
+    int *entries;   // PT_ENTRIES per node: child node, PT_ABSENT, or leaf state
+    int n_nodes;
+    int capacity;   // Nodes allocated in 'entries'
+    int huge;       // Leaves are PD entries mapping 2MB
+} PageTable;
+
+static inline int pt_new_node(PageTable* pt) {
+    if (pt->n_nodes == pt->capacity) {
+        pt->capacity *= 2;
+        pt->entries = (int*)realloc(pt->entries, (size_t)pt->capacity * PT_ENTRIES * sizeof(int));
+    }
+    int* node = pt->entries + (size_t)pt->n_nodes * PT_ENTRIES;
+    for (int i = 0; i < PT_ENTRIES; i++) node[i] = PT_ABSENT;
+    return pt->n_nodes++;
+}
+
+static inline void pt_init(PageTable* pt, int huge) {
+    pt->capacity = 64;
+    pt->entries = (int*)malloc((size_t)pt->capacity * PT_ENTRIES * sizeof(int));
+    pt->n_nodes = 0;
+    pt->huge = huge;
+    pt_new_node(pt);
+}
+
+static inline void pt_free(PageTable* pt) {
+    free(pt->entries);
+}
+
+// Table index of a 4KB virtual page number at 'level' (3 = PML4 ... 0 = PT).
+static inline int pt_index(uint64_t vpn, int level) {
+    return (int)((vpn >> (level * PT_INDEX_BITS)) & (PT_ENTRIES - 1));
+}
+
+// Lowest level the walk reads: the PT for 4KB pages, the PD for 2MB pages.
+static inline int pt_leaf_level(const PageTable* pt) {
+    return pt->huge ? 1 : 0;
+}
+
+/**
+ * @brief Walks the table for a 4KB virtual page number.
+ * @param refs Incremented by the number of table entries read.
+ * @return 1 if the leaf maps a resident page, 0 if the walk ends in a fault.
+ */
+static inline int pt_walk(const PageTable* pt, uint64_t vpn, long long* refs) {
+    int node = 0;
+    for (int level = PT_LEVELS - 1; ; level--) {
+        int entry = pt->entries[(size_t)node * PT_ENTRIES + pt_index(vpn, level)];
+        (*refs)++;
+        if (level == pt_leaf_level(pt)) return entry >= 0;
+        if (entry == PT_ABSENT) return 0;
+        node = entry;
+    }
+}
+
+/**
+ * @brief Marks the page containing 'vpn' resident (present) or swapped out,
+ *        allocating any missing table nodes on the way down.
+ */
+static inline void pt_set_present(PageTable* pt, uint64_t vpn, int present) {
+    int node = 0;
+    for (int level = PT_LEVELS - 1; level > pt_leaf_level(pt); level--) {
+        size_t slot = (size_t)node * PT_ENTRIES + pt_index(vpn, level);
+        if (pt->entries[slot] == PT_ABSENT) {
+            int child = pt_new_node(pt); // May move 'entries'
+            pt->entries[slot] = child;
+        }
+        node = pt->entries[slot];
+    }
+    pt->entries[(size_t)node * PT_ENTRIES + pt_index(vpn, pt_leaf_level(pt))] = present ? 1 : PT_SWAPPED;
+}
+
+#endif // TLB_SIM_H
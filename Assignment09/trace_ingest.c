@@ -0,0 +1,275 @@
+/*
+ * trace_ingest.c
+ * ==============
+ * Converts a raw memory address trace into the compact page reference trace
+ * read by page_replacement --trace (format described in ref_trace.h).
+ *
+ * Every address is cut down to its page number with the configured page size
+ * and pages are renumbered with dense 32-bit ids in order of first use. The
+ * references are stored as zigzag delta varints, and the original page
+ * numbers are kept in a table at the end of the file.
+ *
+ * Usage:
+ *   ./trace_ingest [options] OUTPUT [INPUT]      (INPUT defaults to stdin)
+ *   ./trace_ingest --info TRACE
+ *
+ * Options:
+ *   --page-size BYTES  Page size, a power of two (default 4096)
+ *   --format lackey    Valgrind lackey output (valgrind --tool=lackey
+ *                      --trace-mem=yes): "I  0400d7d4,8", " L 04222cac,8",
+ *                      " S ...", " M ...". An access that crosses a page
+ *                      boundary references both pages. (default)
+ *   --format perf      One address per line in whitespace-separated column
+ *                      --field N (1-based, default 1), hex with or without
+ *                      0x, e.g. perf script -F addr or perf mem report -D
+ *                      output. Lines without a hex address there are skipped.
+ *   --format pages     Whitespace-separated decimal page numbers (the page
+ *                      size is not applied), e.g. an existing reference string.
+ *   --data-only        Lackey: skip instruction fetches (I records).
+ *   --info TRACE       Print the header and size of an existing trace.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <ctype.h>
+#include "page_map.h"
+#include "ref_trace.h"
+
+typedef enum { FORMAT_LACKEY, FORMAT_PERF, FORMAT_PAGES } InputFormat;
+
+/* Page number -> dense id assignment */
+typedef struct {
+    PageMap ids;           // Page number -> id
+    uint64_t *pages;       // id -> page number
+    uint64_t distinct;
+    uint64_t capacity;
+    RefTraceWriter out;
+} Ingest;
+
+// --- Function Prototypes ---
+int parse_hex(const char** p, uint64_t* out);
+void ingest_page(Ingest* in, uint64_t page);
+int ingest_stream(Ingest* in, FILE* fp, InputFormat format, int field, int data_only, uint32_t page_shift, long* skipped);
+int print_info(const char* path);
+void usage(const char* prog);
+
+int main(int argc, char* argv[]) {
+    InputFormat format = FORMAT_LACKEY;
+    uint64_t page_size = 4096;
+    int field = 1, data_only = 0;
+    const char *output = NULL, *input = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--info") == 0 && i + 1 < argc) {
+            return print_info(argv[i + 1]) == 0 ? 0 : 1;
+        } else if (strcmp(argv[i], "--page-size") == 0 && i + 1 < argc) {
+            page_size = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "lackey") == 0) format = FORMAT_LACKEY;
+            else if (strcmp(argv[i], "perf") == 0) format = FORMAT_PERF;
+            else if (strcmp(argv[i], "pages") == 0) format = FORMAT_PAGES;
+            else {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--field") == 0 && i + 1 < argc) {
+            field = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--data-only") == 0) {
+            data_only = 1;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            usage(argv[0]);
+            return 1;
+        } else if (output == NULL) {
+            output = argv[i];
+        } else if (input == NULL) {
+            input = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (output == NULL || field < 1 || page_size == 0 || (page_size & (page_size - 1)) != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    uint32_t page_shift = 0;
+    while ((1ULL << page_shift) < page_size) page_shift++;
+
+    FILE* fp = stdin;
+    if (input != NULL && (fp = fopen(input, "r")) == NULL) {
+        perror(input);
+        return 1;
+    }
+
+    Ingest in;
+    page_map_init(&in.ids, 1024);
+    in.capacity = 1024;
+    in.pages = (uint64_t*)malloc(in.capacity * sizeof(uint64_t));
+    in.distinct = 0;
+    if (ref_trace_create(&in.out, output, format == FORMAT_PAGES ? 0 : page_shift) != 0) return 1;
+
+    long skipped = 0;
+    int status = ingest_stream(&in, fp, format, field, data_only, page_shift, &skipped);
+    if (fp != stdin) fclose(fp);
+    uint64_t count = in.out.count;
+    if (ref_trace_finish(&in.out, in.pages, in.distinct) != 0) status = -1;
+
+    if (status == 0) {
+        uint64_t body = in.out.bytes;
+        fprintf(stderr, "%llu references, %llu distinct pages, %llu bytes of references (%.2f per reference)",
+                (unsigned long long)count, (unsigned long long)in.distinct, (unsigned long long)body,
+                count ? (double)body / count : 0.0);
+        if (skipped > 0) fprintf(stderr, ", %ld lines skipped", skipped);
+        fprintf(stderr, "\n");
+    }
+    page_map_free(&in.ids);
+    free(in.pages);
+    return status == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Parses a hex number (optional 0x prefix) at *p, advancing *p past it.
+ * @return 0 on success, -1 if there are no hex digits or more than 16.
+ */
+int parse_hex(const char** p, uint64_t* out) {
+    const char* s = *p;
+    uint64_t value = 0;
+    int digits = 0;
+
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) s += 2;
+    while (isxdigit((unsigned char)*s)) {
+        int d = isdigit((unsigned char)*s) ? *s - '0' : (tolower((unsigned char)*s) - 'a' + 10);
+        value = (value << 4) | (uint64_t)d;
+        digits++;
+        s++;
+    }
+    if (digits == 0 || digits > 16) return -1;
+    *p = s;
+    *out = value;
+    return 0;
+}
+
+/**
+ * @brief Appends one reference to 'page', assigning it the next id on first use.
+ */
+void ingest_page(Ingest* in, uint64_t page) {
+    int id = page_map_get(&in->ids, page);
+    if (id == -1) {
+        if (in->distinct == in->capacity) {
+            in->capacity *= 2;
+            in->pages = (uint64_t*)realloc(in->pages, in->capacity * sizeof(uint64_t));
+        }
+        id = (int)in->distinct;
+        in->pages[in->distinct++] = page;
+        page_map_put(&in->ids, page, id);
+    }
+    ref_trace_append(&in->out, (uint32_t)id);
+}
+
+/**
+ * @brief Reads the input (line by line, or number by number for the pages
+ *        format) and appends every reference it contains.
+ * @param skipped Receives the number of lines that held no usable address
+ *        (for the pages format, 1 if reading stopped at a non-number).
+ * @return 0 on success, -1 if the trace outgrows 32-bit ids.
+ */
+int ingest_stream(Ingest* in, FILE* fp, InputFormat format, int field, int data_only, uint32_t page_shift, long* skipped) {
+    char *line = NULL;
+    size_t line_cap = 0;
+    int status = 0;
+
+    if (format == FORMAT_PAGES) {
+        uint64_t page;
+        while (fscanf(fp, "%" SCNu64, &page) == 1) {
+            if (in->distinct > 0x7fffffff || in->out.count >= 0x7fffffff) {
+                fprintf(stderr, "Trace too large for 32-bit page ids\n");
+                return -1;
+            }
+            ingest_page(in, page);
+        }
+        if (!feof(fp)) (*skipped)++; // Stopped at something that is not a page number
+        return 0;
+    }
+
+    while (getline(&line, &line_cap, fp) != -1) {
+        const char* p = line;
+        uint64_t addr;
+
+        if (in->distinct > 0x7fffffff || in->out.count >= 0x7fffffff) {
+            fprintf(stderr, "Trace too large for 32-bit page ids\n");
+            status = -1;
+            break;
+        }
+
+        if (format == FORMAT_LACKEY) {
+            // "I  0400d7d4,8" or " L 04222cac,8"; Valgrind's own "==pid==" lines are skipped.
+            while (*p == ' ') p++;
+            char kind = *p;
+            if ((kind != 'I' && kind != 'L' && kind != 'S' && kind != 'M') || p[1] != ' ') {
+                (*skipped)++;
+                continue;
+            }
+            if (kind == 'I' && data_only) continue;
+            p++;
+            while (*p == ' ') p++;
+            uint64_t size = 1;
+            if (parse_hex(&p, &addr) != 0) {
+                (*skipped)++;
+                continue;
+            }
+            if (*p == ',') size = strtoull(p + 1, NULL, 10);
+            if (size == 0) size = 1;
+            uint64_t first = addr >> page_shift, last = (addr + size - 1) >> page_shift;
+            ingest_page(in, first);
+            if (last != first) ingest_page(in, last);
+            continue;
+        }
+
+        // perf: the address is whitespace-separated column 'field'; '#' starts a comment line.
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#') continue;
+        for (int f = 1; ; f++) {
+            while (*p == ' ' || *p == '\t') p++;
+            if (f == field || *p == '\0' || *p == '\n') break;
+            while (*p != '\0' && !isspace((unsigned char)*p)) p++;
+        }
+        const char* start = p;
+        if (parse_hex(&p, &addr) != 0 || (*p != '\0' && !isspace((unsigned char)*p))) {
+            if (*start != '\0' && *start != '\n') (*skipped)++;
+            continue;
+        }
+        ingest_page(in, addr >> page_shift);
+    }
+    free(line);
+    return status;
+}
+
+/**
+ * @brief Prints the header of an existing trace and how well it compressed.
+ */
+int print_info(const char* path) {
+    RefTrace t;
+    if (ref_trace_open(&t, path) != 0) return -1;
+
+    size_t body = (size_t)(t.end - t.body);
+    printf("Trace:            %s\n", path);
+    if (t.page_shift > 0) printf("Page size:        %llu bytes\n", 1ULL << t.page_shift);
+    else printf("Page size:        (page numbers given directly)\n");
+    printf("References:       %llu\n", (unsigned long long)t.count);
+    printf("Distinct pages:   %llu\n", (unsigned long long)t.distinct);
+    printf("Reference bytes:  %zu (%.2f per reference, %.1fx smaller than int32)\n", body,
+           t.count ? (double)body / t.count : 0.0, body ? 4.0 * t.count / body : 0.0);
+    printf("Page table bytes: %zu\n", (size_t)(t.distinct * sizeof(uint64_t)));
+    ref_trace_close(&t);
+    return 0;
+}
+
+void usage(const char* prog) {
+    fprintf(stderr, "Usage: %s [--page-size BYTES] [--format lackey|perf|pages] [--field N] [--data-only] OUTPUT [INPUT]\n"
+                    "       %s --info TRACE\n", prog, prog);
+}
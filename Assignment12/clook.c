@@ -16,73 +16,105 @@
  *    request without servicing anything in between.
  * 4. The head continues moving in the same direction (towards higher numbers),
  *    servicing the remaining requests.
+ *
+ * Tracks are 64-bit LBAs; C-LOOK never needs the end of the disk, so any
+ * value is accepted unless --disk-size TRACKS is given to validate input.
+ * Requests are sorted with an LSD radix sort, and the head movement total
+ * cannot overflow (see lba.h).
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-
-// Comparison function for qsort to sort integers in ascending order.
-int compare(const void* a, const void* b) {
-    return (*(int*)a - *(int*)b);
-}
+#include <string.h>
+#include <limits.h>
+#include "lba.h" // 64-bit tracks, radix sort, overflow-safe movement totals
 
 /**
  * @brief Simulates the C-LOOK disk scheduling algorithm.
- * @param requests Array of track requests.
+ * @param requests Array of track requests (sorted in place).
  * @param n Number of requests.
  * @param head The initial position of the disk head.
  */
-void run_clook(int requests[], int n, int head) {
-    int total_movement = 0;
-    int current_head = head;
+void run_clook(lba_t requests[], size_t n, lba_t head) {
+    movement_t total_movement = 0;
+    lba_t current_head = head;
 
     // Sort the requests to make it easier to find the next track.
-    qsort(requests, n, sizeof(int), compare);
+    if (radix_sort_lba(requests, n) != 0) {
+        fprintf(stderr, "Out of memory sorting %zu requests\n", n);
+        return;
+    }
 
-    printf("Seek Sequence: %d", head);
+    printf("Seek Sequence: %llu", head);
 
     // --- Pass 1: Move from head towards the highest request ---
-    for (int i = 0; i < n; i++) {
+    for (size_t i = 0; i < n; i++) {
         // Service all requests that are >= the current head position.
         if (requests[i] >= current_head) {
-            total_movement += abs(requests[i] - current_head);
+            total_movement += lba_distance(requests[i], current_head);
             current_head = requests[i];
-            printf(" -> %d", current_head);
+            printf(" -> %llu", current_head);
         }
     }
 
-    // --- Jump to the lowest request and continue ---
-    // The head jumps from the last serviced (highest) request to the first (lowest) request.
-    total_movement += abs(requests[0] - current_head);
-    current_head = requests[0];
-    printf(" -> %d", current_head);
+    if (n > 0) {
+        // --- Jump to the lowest request and continue ---
+        // The head jumps from the last serviced (highest) request to the first (lowest) request.
+        total_movement += lba_distance(requests[0], current_head);
+        current_head = requests[0];
+        printf(" -> %llu", current_head);
+    }
 
     // --- Pass 2: Move from the lowest request up to the initial head position ---
-    for (int i = 1; i < n; i++) {
+    for (size_t i = 1; i < n; i++) {
         // Service the remaining requests (those that were < initial head).
         if (requests[i] < head) {
-            total_movement += abs(requests[i] - current_head);
+            total_movement += lba_distance(requests[i], current_head);
             current_head = requests[i];
-            printf(" -> %d", current_head);
+            printf(" -> %llu", current_head);
         } else {
             // Since the array is sorted, we can stop once we pass the initial head's zone.
             break;
         }
     }
-    printf("\nTotal head movement: %d\n", total_movement);
+    printf("\nTotal head movement: ");
+    print_movement(total_movement);
+    printf("\n");
 }
 
-int main() {
-    int n, head;
+int main(int argc, char* argv[]) {
+    int n;
+    lba_t head;
+    lba_t max_track = ULLONG_MAX; // Highest valid track; --disk-size TRACKS makes it TRACKS-1.
+
+    if (argc == 3 && strcmp(argv[1], "--disk-size") == 0) {
+        lba_t disk_size = strtoull(argv[2], NULL, 0);
+        if (disk_size == 0) return 1;
+        max_track = disk_size - 1;
+    } else if (argc != 1) {
+        fprintf(stderr, "Usage: %s [--disk-size TRACKS]\n", argv[0]);
+        return 1;
+    }
+
     printf("Enter number of requests: ");
-    scanf("%d", &n);
+    if (scanf("%d", &n) != 1 || n < 0) return 1;
 
-    int* requests = malloc(n * sizeof(int));
+    lba_t* requests = (lba_t*)malloc((n > 0 ? n : 1) * sizeof(lba_t));
     printf("Enter requests:\n");
-    for(int i = 0; i < n; i++) scanf("%d", &requests[i]);
+    for (int i = 0; i < n; i++) {
+        if (scanf("%llu", &requests[i]) != 1 || requests[i] > max_track) {
+            fprintf(stderr, "Request %d is not a track in 0..%llu (see --disk-size).\n", i + 1, max_track);
+            free(requests);
+            return 1;
+        }
+    }
 
     printf("Enter head: ");
-    scanf("%d", &head);
+    if (scanf("%llu", &head) != 1 || head > max_track) {
+        fprintf(stderr, "The head must be a track in 0..%llu (see --disk-size).\n", max_track);
+        free(requests);
+        return 1;
+    }
 
     run_clook(requests, n, head);
     free(requests);
@@ -0,0 +1,437 @@
+/*
+ * disk_sched.h
+ * ============
+ * Online disk scheduling: requests join a pending set while the head is
+ * moving, and the scheduler picks the next one each time the head finishes a
+ * request.
+ *
+ * Pending requests live in a red-black tree ordered by (track, arrival
+ * order), so the nearest request at or above / at or below the head is
+ * found in O(log n) whatever the queue length. A FIFO of request indices
+ * in arrival order serves FCFS and deadline expiry; serviced entries are
+ * skipped lazily, so it costs O(1) amortized.
+ *
+ * Policies (DiskAlgorithm):
+ * - FCFS:     oldest pending request first.
+ * - SSTF:     nearest track; equal distances go to the earlier arrival.
+ * - SCAN:     sweep up, then down; with nothing left ahead the head still
+ *             travels to the end of the disk before turning.
+ * - LOOK:     as SCAN, but turns at the last pending request.
+ * - C-SCAN:   sweep up only; at the top end, return to track 0 and sweep again.
+ * - C-LOOK:   as C-SCAN, but jumps from the highest pending request to the lowest.
+ * - Deadline: C-LOOK order, but a request that has waited 'deadline' time
+ *             units is served next (modeled on the Linux deadline scheduler).
+ * Head movement counts every track the head passes, including the return
+ * sweep of C-SCAN and the jump of C-LOOK, as clook.c does.
+ *
+ * Every function is static inline so each simulator can include this header
+ * directly and still be compiled on its own.
+ */
+
+#ifndef DISK_SCHED_H
+#define DISK_SCHED_H
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    DISK_FCFS, DISK_SSTF, DISK_SCAN, DISK_LOOK, DISK_CSCAN, DISK_CLOOK, DISK_DEADLINE, N_DISK_ALGORITHMS
+} DiskAlgorithm;
+
+static const char* const disk_algorithm_names[N_DISK_ALGORITHMS] = {
+    "FCFS", "SSTF", "SCAN", "LOOK", "C-SCAN", "C-LOOK", "Deadline"
+};
+
+/*
+ * Red-black tree of pending requests ordered by (track, index); indices are
+ * assigned in arrival order. Index 'nil' (== n) is the shared black sentinel.
+ */
+typedef struct {
+    int *left, *right, *parent;
+    char *red;          // 1 = red, 0 = black
+    long long *track;   // Sort key of every node
+    int root;
+    int nil;
+} TrackTree;
+
+/**
+ * @brief Tree order: lower track first, ties go to the earlier request.
+ */
+static inline int track_less(const TrackTree* t, int a, int b) {
+    if (t->track[a] != t->track[b]) return t->track[a] < t->track[b];
+    return a < b;
+}
+
+/**
+ * @brief Allocates an empty tree for request indices 0..n-1.
+ */
+static inline void track_tree_init(TrackTree* t, int n) {
+    t->left = (int*)malloc((n + 1) * sizeof(int));
+    t->right = (int*)malloc((n + 1) * sizeof(int));
+    t->parent = (int*)malloc((n + 1) * sizeof(int));
+    t->red = (char*)calloc(n + 1, sizeof(char));
+    t->track = (long long*)calloc(n + 1, sizeof(long long));
+    t->nil = n;
+    t->root = n;
+    t->left[n] = t->right[n] = t->parent[n] = n;
+}
+
+static inline void track_tree_free(TrackTree* t) {
+    free(t->left);
+    free(t->right);
+    free(t->parent);
+    free(t->red);
+    free(t->track);
+}
+
+static inline void track_rotate_left(TrackTree* t, int x) {
+    int y = t->right[x];
+    t->right[x] = t->left[y];
+    if (t->left[y] != t->nil) t->parent[t->left[y]] = x;
+    t->parent[y] = t->parent[x];
+    if (t->parent[x] == t->nil) t->root = y;
+    else if (x == t->left[t->parent[x]]) t->left[t->parent[x]] = y;
+    else t->right[t->parent[x]] = y;
+    t->left[y] = x;
+    t->parent[x] = y;
+}
+
+static inline void track_rotate_right(TrackTree* t, int x) {
+    int y = t->left[x];
+    t->left[x] = t->right[y];
+    if (t->right[y] != t->nil) t->parent[t->right[y]] = x;
+    t->parent[y] = t->parent[x];
+    if (t->parent[x] == t->nil) t->root = y;
+    else if (x == t->right[t->parent[x]]) t->right[t->parent[x]] = y;
+    else t->left[t->parent[x]] = y;
+    t->right[y] = x;
+    t->parent[x] = y;
+}
+
+/**
+ * @brief Inserts node z keyed on t->track[z] (CLRS insert + fixup).
+ */
+static inline void track_insert(TrackTree* t, int z) {
+    int y = t->nil, x = t->root;
+    while (x != t->nil) {
+        y = x;
+        x = track_less(t, z, x) ? t->left[x] : t->right[x];
+    }
+    t->parent[z] = y;
+    if (y == t->nil) t->root = z;
+    else if (track_less(t, z, y)) t->left[y] = z;
+    else t->right[y] = z;
+    t->left[z] = t->right[z] = t->nil;
+    t->red[z] = 1;
+
+    while (t->red[t->parent[z]]) {
+        int p = t->parent[z], g = t->parent[p];
+        if (p == t->left[g]) {
+            int uncle = t->right[g];
+            if (t->red[uncle]) {
+                t->red[p] = t->red[uncle] = 0;
+                t->red[g] = 1;
+                z = g;
+            } else {
+                if (z == t->right[p]) {
+                    z = p;
+                    track_rotate_left(t, z);
+                    p = t->parent[z];
+                }
+                t->red[p] = 0;
+                t->red[g] = 1;
+                track_rotate_right(t, g);
+            }
+        } else {
+            int uncle = t->left[g];
+            if (t->red[uncle]) {
+                t->red[p] = t->red[uncle] = 0;
+                t->red[g] = 1;
+                z = g;
+            } else {
+                if (z == t->left[p]) {
+                    z = p;
+                    track_rotate_right(t, z);
+                    p = t->parent[z];
+                }
+                t->red[p] = 0;
+                t->red[g] = 1;
+                track_rotate_left(t, g);
+            }
+        }
+    }
+    t->red[t->root] = 0;
+}
+
+/**
+ * @brief Replaces subtree u with subtree v.
+ */
+static inline void track_transplant(TrackTree* t, int u, int v) {
+    if (t->parent[u] == t->nil) t->root = v;
+    else if (u == t->left[t->parent[u]]) t->left[t->parent[u]] = v;
+    else t->right[t->parent[u]] = v;
+    t->parent[v] = t->parent[u];
+}
+
+static inline int track_minimum(const TrackTree* t, int x) {
+    while (t->left[x] != t->nil) x = t->left[x];
+    return x;
+}
+
+static inline int track_maximum(const TrackTree* t, int x) {
+    while (t->right[x] != t->nil) x = t->right[x];
+    return x;
+}
+
+/**
+ * @brief Removes node z from the tree (CLRS delete + fixup).
+ */
+static inline void track_erase(TrackTree* t, int z) {
+    int y = z, x;
+    char y_was_red = t->red[y];
+
+    if (t->left[z] == t->nil) {
+        x = t->right[z];
+        track_transplant(t, z, x);
+    } else if (t->right[z] == t->nil) {
+        x = t->left[z];
+        track_transplant(t, z, x);
+    } else {
+        y = track_minimum(t, t->right[z]);
+        y_was_red = t->red[y];
+        x = t->right[y];
+        if (t->parent[y] == z) {
+            t->parent[x] = y;
+        } else {
+            track_transplant(t, y, t->right[y]);
+            t->right[y] = t->right[z];
+            t->parent[t->right[y]] = y;
+        }
+        track_transplant(t, z, y);
+        t->left[y] = t->left[z];
+        t->parent[t->left[y]] = y;
+        t->red[y] = t->red[z];
+    }
+
+    if (!y_was_red) {
+        while (x != t->root && !t->red[x]) {
+            int p = t->parent[x];
+            if (x == t->left[p]) {
+                int w = t->right[p];
+                if (t->red[w]) {
+                    t->red[w] = 0;
+                    t->red[p] = 1;
+                    track_rotate_left(t, p);
+                    w = t->right[p];
+                }
+                if (!t->red[t->left[w]] && !t->red[t->right[w]]) {
+                    t->red[w] = 1;
+                    x = p;
+                } else {
+                    if (!t->red[t->right[w]]) {
+                        t->red[t->left[w]] = 0;
+                        t->red[w] = 1;
+                        track_rotate_right(t, w);
+                        w = t->right[p];
+                    }
+                    t->red[w] = t->red[p];
+                    t->red[p] = 0;
+                    t->red[t->right[w]] = 0;
+                    track_rotate_left(t, p);
+                    x = t->root;
+                }
+            } else {
+                int w = t->left[p];
+                if (t->red[w]) {
+                    t->red[w] = 0;
+                    t->red[p] = 1;
+                    track_rotate_right(t, p);
+                    w = t->left[p];
+                }
+                if (!t->red[t->right[w]] && !t->red[t->left[w]]) {
+                    t->red[w] = 1;
+                    x = p;
+                } else {
+                    if (!t->red[t->left[w]]) {
+                        t->red[t->right[w]] = 0;
+                        t->red[w] = 1;
+                        track_rotate_left(t, w);
+                        w = t->left[p];
+                    }
+                    t->red[w] = t->red[p];
+                    t->red[p] = 0;
+                    t->red[t->left[w]] = 0;
+                    track_rotate_right(t, p);
+                    x = t->root;
+                }
+            }
+        }
+        t->red[x] = 0;
+    }
+    t->parent[t->nil] = t->nil; // Fixup may have written through the sentinel
+}
+
+/**
+ * @brief First request (lowest index) on the lowest track >= 'track', or nil.
+ */
+static inline int track_ceiling(const TrackTree* t, long long track) {
+    int x = t->root, best = t->nil;
+    while (x != t->nil) {
+        if (t->track[x] >= track) {
+            best = x;
+            x = t->left[x];
+        } else {
+            x = t->right[x];
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief First request (lowest index) on the highest track <= 'track', or nil.
+ */
+static inline int track_floor(const TrackTree* t, long long track) {
+    int x = t->root, best = t->nil;
+    while (x != t->nil) {
+        if (t->track[x] <= track) {
+            best = x;
+            x = t->right[x];
+        } else {
+            x = t->left[x];
+        }
+    }
+    // 'best' is the last request on that track; its earliest one comes first.
+    return (best == t->nil) ? best : track_ceiling(t, t->track[best]);
+}
+
+/* Scheduler state: pending requests, head position and sweep direction */
+typedef struct {
+    DiskAlgorithm algorithm;
+    TrackTree tree;
+    int *fifo;             // Request indices in arrival order
+    int fifo_head, fifo_tail;
+    char *done;            // Serviced requests, skipped when they reach the FIFO head
+    const long long *arrival;
+    int pending;
+    long long head;        // Current track
+    int up;                // Sweep direction: 1 towards higher tracks
+    long long disk_size;   // Tracks 0..disk_size-1 (SCAN and C-SCAN sweep to the ends)
+    long long deadline;    // Deadline: maximum wait before a request jumps the queue
+} DiskScheduler;
+
+/**
+ * @brief Prepares a scheduler for requests 0..n-1, indexed in arrival order.
+ * @param arrival Arrival time of each request (read when the deadline policy runs).
+ */
+static inline void disk_init(DiskScheduler* s, DiskAlgorithm algorithm, int n, const long long arrival[],
+                             long long head, long long disk_size, long long deadline) {
+    s->algorithm = algorithm;
+    track_tree_init(&s->tree, n);
+    s->fifo = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    s->fifo_head = s->fifo_tail = 0;
+    s->done = (char*)calloc(n > 0 ? n : 1, sizeof(char));
+    s->arrival = arrival;
+    s->pending = 0;
+    s->head = head;
+    s->up = 1;
+    s->disk_size = disk_size;
+    s->deadline = deadline;
+}
+
+static inline void disk_free(DiskScheduler* s) {
+    track_tree_free(&s->tree);
+    free(s->fifo);
+    free(s->done);
+}
+
+/**
+ * @brief Adds request 'r' on 'track' to the pending set. Requests must be
+ *        added in index (arrival) order.
+ */
+static inline void disk_add(DiskScheduler* s, int r, long long track) {
+    s->tree.track[r] = track;
+    track_insert(&s->tree, r);
+    s->fifo[s->fifo_tail++] = r;
+    s->pending++;
+}
+
+// Oldest pending request.
+static inline int disk_oldest(DiskScheduler* s) {
+    while (s->done[s->fifo[s->fifo_head]]) s->fifo_head++;
+    return s->fifo[s->fifo_head];
+}
+
+static inline long long disk_distance(long long a, long long b) {
+    return a > b ? a - b : b - a;
+}
+
+/**
+ * @brief Chooses the next request, moves the head there and removes it from
+ *        the pending set. There must be at least one pending request.
+ * @param now Current time (for deadline expiry).
+ * @param movement Receives the tracks the head travels, including any turn at
+ *        a disk end or return sweep on the way.
+ * @return The request serviced.
+ */
+static inline int disk_next(DiskScheduler* s, long long now, long long* movement) {
+    TrackTree* t = &s->tree;
+    long long head = s->head, travel = 0;
+    int r = t->nil;
+
+    switch (s->algorithm) {
+    case DISK_FCFS:
+        r = disk_oldest(s);
+        break;
+    case DISK_SSTF: {
+        int above = track_ceiling(t, head), below = track_floor(t, head);
+        if (above == t->nil) r = below;
+        else if (below == t->nil) r = above;
+        else {
+            long long d_above = t->track[above] - head, d_below = head - t->track[below];
+            r = (d_below < d_above || (d_below == d_above && below < above)) ? below : above;
+        }
+        break;
+    }
+    case DISK_SCAN:
+    case DISK_LOOK:
+        r = s->up ? track_ceiling(t, head) : track_floor(t, head);
+        if (r == t->nil) {
+            if (s->algorithm == DISK_SCAN) {
+                long long end = s->up ? s->disk_size - 1 : 0;
+                travel += disk_distance(head, end);
+                head = end;
+            }
+            s->up = !s->up;
+            r = s->up ? track_ceiling(t, head) : track_floor(t, head);
+        }
+        break;
+    case DISK_DEADLINE:
+        r = disk_oldest(s);
+        if (now - s->arrival[r] >= s->deadline) break;
+        // Not expired: C-LOOK order
+        /* fall through */
+    case DISK_CSCAN:
+    case DISK_CLOOK:
+        r = track_ceiling(t, head);
+        if (r == t->nil) {
+            if (s->algorithm == DISK_CSCAN) {
+                travel += disk_distance(head, s->disk_size - 1) + (s->disk_size - 1);
+                head = 0;
+            }
+            r = track_minimum(t, t->root);
+        }
+        break;
+    default:
+        break;
+    }
+
+    travel += disk_distance(head, t->track[r]);
+    s->head = t->track[r];
+    track_erase(t, r);
+    s->done[r] = 1;
+    s->pending--;
+    *movement = travel;
+    return r;
+}
+
+#endif // DISK_SCHED_H
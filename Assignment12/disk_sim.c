@@ -0,0 +1,385 @@
+/*
+ * disk_sim.c
+ * ==========
+ * Event-driven simulation of disk scheduling with timed request arrivals.
+ *
+ * sstf.c, scan.c and clook.c schedule a batch that is fully known at time 0.
+ * Here every request has an arrival time and only joins the queue once it
+ * has arrived, while the head is busy with earlier ones. Each time the head
+ * finishes a request, the scheduler picks the next one from the requests
+ * pending at that moment (see disk_sched.h for the policies and the
+ * red-black tree that keeps pending requests ordered by track).
+ *
+ * With every arrival at time 0 the orders are the batch programs' orders,
+ * except when no request lies below the head: clook.c then still jumps
+ * back to its lowest request and scan.c still sweeps to the last track,
+ * while here the head stops after the last request.
+ *
+ * Timing model (--device, see disk_timing.h):
+ * - tracks (default): moving the head one track takes one time unit, and
+ *   servicing a request once the head is on its track takes --transfer
+ *   time units (default 1).
+ * - hdd: seek curve, rotational latency and transfer of a 7200 RPM disk;
+ *   times are in microseconds.
+ * - ssd: flash channels and a device queue; seek distance costs nothing,
+ *   times are in microseconds. Up to --queue-depth requests are issued
+ *   before the first completes, in the order the algorithm picks them.
+ * - When nothing is pending, the device waits idle for the next arrival.
+ * A request's latency is its completion time minus its arrival time.
+ *
+ * Algorithms: FCFS, SSTF, SCAN, LOOK, C-SCAN, C-LOOK and Deadline (C-LOOK
+ * order, but a request waiting --deadline time units or more, default 500,
+ * is served next). The head starts sweeping towards higher tracks.
+ *
+ * Usage:
+ *   ./disk_sim                       prompts for the requests
+ *   ./disk_sim --input FILE          reads "N HEAD DISK_SIZE", then N lines
+ *                                    "ARRIVAL TRACK" ('-' = stdin)
+ * Options:
+ *   --algorithm NAME  run one algorithm and print its seek sequence
+ *   --transfer T      service time per request (tracks device)
+ *   --deadline D      expiry time for the Deadline algorithm (device time units)
+ *   --device KIND     tracks, hdd or ssd
+ *   --rpm R           hdd: spindle speed (default 7200)
+ *   --seek S,F,K      hdd: settle and full-stroke seek in us, knee as a
+ *                     fraction of the stroke (default 1000,16000,0.3)
+ *   --request-kb K    hdd: request size (default 4)
+ *   --track-kb K      hdd: data per track (default 1024)
+ *   --flash-us T      ssd: service time on one channel (default 80)
+ *   --channels C      ssd: independent channels (default 8)
+ *   --queue-depth Q   ssd: requests in flight (default 32)
+ * Without --algorithm every algorithm runs and the report is a table of
+ * total head movement and latency mean, p50, p90, p99 and max, plus IOPS
+ * (requests per second from the first arrival to the last completion) on
+ * the hdd and ssd devices.
+ *
+ * Compile with: gcc disk_sim.c -o disk_sim -lm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "disk_sched.h" // Pending request tree and scheduling policies
+#include "disk_timing.h" // Service time of the tracks, hdd and ssd devices
+
+#define DEFAULT_TRANSFER_TIME 1
+#define DEFAULT_DEADLINE 500
+
+/* Requests sorted by arrival time; index i is the i-th request to arrive */
+typedef struct {
+    int n;
+    long long *arrival;
+    long long *track;
+    long long head;       // Initial head position
+    long long disk_size;  // Tracks 0..disk_size-1
+} RequestStream;
+
+/* Results of one simulation */
+typedef struct {
+    long long movement;   // Total tracks traveled
+    long long finish;     // Completion time of the last request
+    long long *latency;   // Per request, in arrival order
+} DiskResult;
+
+// --- Function Prototypes ---
+int read_stream(FILE* fp, int prompt, RequestStream* rs);
+void free_stream(RequestStream* rs);
+int compare_arrival(const void* a, const void* b);
+int compare_ll(const void* a, const void* b);
+int parse_device_option(int argc, char* argv[], int* i, DeviceModel* dev);
+void simulate(DiskAlgorithm algorithm, const RequestStream* rs, const DeviceModel* dev, long long deadline,
+              int print_sequence, DiskResult* result);
+double iops(const DeviceModel* dev, const RequestStream* rs, const DiskResult* result);
+void print_latency_row(const char* name, const DiskResult* result, int n, double rate);
+
+int main(int argc, char* argv[]) {
+    const char* input = NULL;
+    long long deadline = DEFAULT_DEADLINE;
+    int only = -1;
+    RequestStream rs;
+    DeviceModel dev;
+
+    device_defaults(&dev, DEVICE_TRACKS);
+    dev.transfer = DEFAULT_TRANSFER_TIME;
+    for (int i = 1; i < argc; i++) {
+        int parsed = parse_device_option(argc, argv, &i, &dev);
+        if (parsed < 0) return 1;
+        if (parsed > 0) continue;
+        if (strcmp(argv[i], "--input") == 0 && i + 1 < argc) {
+            input = argv[++i];
+        } else if (strcmp(argv[i], "--deadline") == 0 && i + 1 < argc) {
+            deadline = atoll(argv[++i]);
+        } else if (strcmp(argv[i], "--algorithm") == 0 && i + 1 < argc) {
+            i++;
+            for (int a = 0; a < N_DISK_ALGORITHMS; a++) {
+                if (strcasecmp(argv[i], disk_algorithm_names[a]) == 0) only = a;
+            }
+            if (only == -1) {
+                fprintf(stderr, "Unknown algorithm %s (FCFS, SSTF, SCAN, LOOK, C-SCAN, C-LOOK, Deadline)\n", argv[i]);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Usage: %s [--input FILE] [--algorithm NAME] [--transfer T] [--deadline D]\n"
+                            "       [--device tracks|hdd|ssd] [--rpm R] [--seek SETTLE,FULL,KNEE]\n"
+                            "       [--request-kb K] [--track-kb K] [--flash-us T] [--channels C] [--queue-depth Q]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (deadline < 0) return 1;
+
+    FILE* fp = stdin;
+    if (input != NULL && strcmp(input, "-") != 0 && (fp = fopen(input, "r")) == NULL) {
+        perror(input);
+        return 1;
+    }
+    int status = read_stream(fp, input == NULL, &rs);
+    if (fp != stdin) fclose(fp);
+    if (status != 0) return 1;
+
+    DiskResult result;
+    result.latency = (long long*)malloc((rs.n > 0 ? rs.n : 1) * sizeof(long long));
+    const char* columns = (dev.kind == DEVICE_TRACKS) ? "Algorithm\tMovement\tMean\tp50\tp90\tp99\tMax\n"
+                                                      : "Algorithm\tMovement\tIOPS\tMean\tp50\tp90\tp99\tMax\n";
+    if (only != -1) {
+        simulate((DiskAlgorithm)only, &rs, &dev, deadline, 1, &result);
+        printf("Total head movement: %lld\n", result.movement);
+        printf("Finished at time %lld\n", result.finish);
+        printf("\n%s", columns);
+        print_latency_row(disk_algorithm_names[only], &result, rs.n, iops(&dev, &rs, &result));
+    } else {
+        printf("\n---=== [ Online Disk Scheduling: %d requests, head %lld, %lld tracks, %s ] ===---\n",
+               rs.n, rs.head, rs.disk_size, device_kind_names[dev.kind]);
+        printf("%s", columns);
+        for (int a = 0; a < N_DISK_ALGORITHMS; a++) {
+            simulate((DiskAlgorithm)a, &rs, &dev, deadline, 0, &result);
+            print_latency_row(disk_algorithm_names[a], &result, rs.n, iops(&dev, &rs, &result));
+        }
+        if (dev.kind == DEVICE_HDD) {
+            printf("Latency = completion - arrival in us; %.0f RPM, seek %.0f-%.0f us, %.0f KB of %.0f KB per track.\n",
+                   dev.rpm, dev.settle_us, dev.full_stroke_us, dev.request_kb, dev.track_kb);
+        } else if (dev.kind == DEVICE_SSD) {
+            printf("Latency = completion - arrival in us; %.0f us per request, %d channels, queue depth %d.\n",
+                   dev.flash_us, dev.channels, dev.queue_depth);
+        } else {
+            printf("Latency = completion - arrival; 1 time unit per track, %lld per transfer.\n", dev.transfer);
+        }
+    }
+    free(result.latency);
+    free_stream(&rs);
+    return 0;
+}
+
+/**
+ * @brief Reads the request stream, with prompts when 'prompt' is set, and
+ *        sorts it by arrival time (ties keep their input order).
+ * @return 0 on success, -1 on bad input.
+ */
+int read_stream(FILE* fp, int prompt, RequestStream* rs) {
+    if (prompt) printf("Enter number of requests: ");
+    if (fscanf(fp, "%d", &rs->n) != 1 || rs->n < 0) return -1;
+    if (prompt) printf("Enter head: ");
+    if (fscanf(fp, "%lld", &rs->head) != 1) return -1;
+    if (prompt) printf("Enter disk size (tracks): ");
+    if (fscanf(fp, "%lld", &rs->disk_size) != 1 || rs->disk_size <= 0) return -1;
+    if (rs->head < 0 || rs->head >= rs->disk_size) {
+        fprintf(stderr, "Head %lld is outside 0..%lld.\n", rs->head, rs->disk_size - 1);
+        return -1;
+    }
+
+    // Read (arrival, track, input position) triples, then sort them by arrival.
+    long long (*raw)[3] = malloc((rs->n > 0 ? rs->n : 1) * sizeof(*raw));
+    if (prompt) printf("Enter requests (arrival time and track):\n");
+    for (int i = 0; i < rs->n; i++) {
+        if (fscanf(fp, "%lld %lld", &raw[i][0], &raw[i][1]) != 2) {
+            fprintf(stderr, "Expected %d requests, got %d.\n", rs->n, i);
+            free(raw);
+            return -1;
+        }
+        if (raw[i][1] < 0 || raw[i][1] >= rs->disk_size) {
+            fprintf(stderr, "Request %d: track %lld is outside 0..%lld.\n", i, raw[i][1], rs->disk_size - 1);
+            free(raw);
+            return -1;
+        }
+        raw[i][2] = i;
+    }
+    qsort(raw, rs->n, sizeof(*raw), compare_arrival);
+
+    rs->arrival = (long long*)malloc((rs->n > 0 ? rs->n : 1) * sizeof(long long));
+    rs->track = (long long*)malloc((rs->n > 0 ? rs->n : 1) * sizeof(long long));
+    for (int i = 0; i < rs->n; i++) {
+        rs->arrival[i] = raw[i][0];
+        rs->track[i] = raw[i][1];
+    }
+    free(raw);
+    return 0;
+}
+
+void free_stream(RequestStream* rs) {
+    free(rs->arrival);
+    free(rs->track);
+}
+
+// Comparison function for qsort: (arrival, track, input position) triples by arrival, then input order.
+int compare_arrival(const void* a, const void* b) {
+    const long long* x = (const long long*)a;
+    const long long* y = (const long long*)b;
+    if (x[0] != y[0]) return (x[0] > y[0]) - (x[0] < y[0]);
+    return (x[2] > y[2]) - (x[2] < y[2]);
+}
+
+// Comparison function for qsort to sort long longs in ascending order.
+int compare_ll(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Parses argv[*i] if it is a device option, advancing *i past its value.
+ * @return 1 if it was one, 0 if not, -1 on a bad value (message on stderr).
+ */
+int parse_device_option(int argc, char* argv[], int* i, DeviceModel* dev) {
+    const char* opt = argv[*i];
+    if (*i + 1 >= argc) return 0;
+    const char* value = argv[*i + 1];
+
+    if (strcmp(opt, "--device") == 0) {
+        int kind = -1;
+        for (int k = 0; k < N_DEVICE_KINDS; k++) {
+            if (strcasecmp(value, device_kind_names[k]) == 0) kind = k;
+        }
+        if (kind == -1) {
+            fprintf(stderr, "Unknown device %s (tracks, hdd, ssd)\n", value);
+            return -1;
+        }
+        dev->kind = (DeviceKind)kind;
+    } else if (strcmp(opt, "--transfer") == 0) {
+        dev->transfer = atoll(value);
+        if (dev->transfer < 0) return -1;
+    } else if (strcmp(opt, "--rpm") == 0) {
+        dev->rpm = atof(value);
+        if (dev->rpm <= 0) return -1;
+    } else if (strcmp(opt, "--seek") == 0) {
+        if (sscanf(value, "%lf,%lf,%lf", &dev->settle_us, &dev->full_stroke_us, &dev->knee) != 3 ||
+            dev->settle_us < 0 || dev->full_stroke_us < dev->settle_us || dev->knee <= 0 || dev->knee > 1) {
+            fprintf(stderr, "--seek wants SETTLE_US,FULL_STROKE_US,KNEE with 0 < KNEE <= 1\n");
+            return -1;
+        }
+    } else if (strcmp(opt, "--request-kb") == 0) {
+        dev->request_kb = atof(value);
+        if (dev->request_kb <= 0) return -1;
+    } else if (strcmp(opt, "--track-kb") == 0) {
+        dev->track_kb = atof(value);
+        if (dev->track_kb <= 0) return -1;
+    } else if (strcmp(opt, "--flash-us") == 0) {
+        dev->flash_us = atof(value);
+        if (dev->flash_us < 0) return -1;
+    } else if (strcmp(opt, "--channels") == 0) {
+        dev->channels = atoi(value);
+        if (dev->channels < 1) return -1;
+    } else if (strcmp(opt, "--queue-depth") == 0) {
+        dev->queue_depth = atoi(value);
+        if (dev->queue_depth < 1) return -1;
+    } else {
+        return 0;
+    }
+    (*i)++;
+    return 1;
+}
+
+/**
+ * @brief Runs one algorithm over the stream. The clock jumps from event to
+ *        event: a completion, or an arrival while the device has room.
+ *        Whenever the device can take another request the algorithm picks one.
+ * @param print_sequence Print the seek sequence as the batch simulators do.
+ */
+void simulate(DiskAlgorithm algorithm, const RequestStream* rs, const DeviceModel* dev, long long deadline,
+              int print_sequence, DiskResult* result) {
+    DiskScheduler s;
+    DeviceState st;
+    int slots = device_slots(dev), in_flight = 0;
+    int* slot_request = (int*)malloc(slots * sizeof(int));
+    long long* slot_finish = (long long*)malloc(slots * sizeof(long long));
+    long long now = 0;
+    int next = 0, serviced = 0;
+
+    disk_init(&s, algorithm, rs->n, rs->arrival, rs->head, rs->disk_size, deadline);
+    device_state_init(&st, dev);
+    result->movement = 0;
+    if (print_sequence) printf("%s Seek Sequence: %lld", disk_algorithm_names[algorithm], rs->head);
+
+    while (serviced < rs->n) {
+        // Admit everything that has arrived by now.
+        while (next < rs->n && rs->arrival[next] <= now) {
+            disk_add(&s, next, rs->track[next]);
+            next++;
+        }
+        // Fill the device in the order the algorithm picks.
+        while (in_flight < slots && s.pending > 0) {
+            long long movement;
+            int r = disk_next(&s, now, &movement);
+            result->movement += movement;
+            slot_request[in_flight] = r;
+            slot_finish[in_flight] = device_dispatch(dev, &st, r, rs->track[r], movement, rs->disk_size, now);
+            in_flight++;
+            if (print_sequence) printf(" -> %lld", rs->track[r]);
+        }
+        if (in_flight == 0) {
+            now = rs->arrival[next]; // Idle until the next arrival
+            continue;
+        }
+
+        int first = 0;
+        for (int k = 1; k < in_flight; k++) {
+            if (slot_finish[k] < slot_finish[first]) first = k;
+        }
+        if (in_flight < slots && next < rs->n && rs->arrival[next] < slot_finish[first]) {
+            now = rs->arrival[next]; // Room for a request that arrives before the next completion
+            continue;
+        }
+        now = slot_finish[first];
+        int r = slot_request[first];
+        result->latency[r] = now - rs->arrival[r];
+        serviced++;
+        in_flight--;
+        slot_request[first] = slot_request[in_flight];
+        slot_finish[first] = slot_finish[in_flight];
+    }
+    if (print_sequence) printf("\n");
+    result->finish = now;
+    device_state_free(&st);
+    disk_free(&s);
+    free(slot_request);
+    free(slot_finish);
+}
+
+/**
+ * @brief Requests per second from the first arrival to the last completion,
+ *        or -1 where time is not in microseconds (tracks device).
+ */
+double iops(const DeviceModel* dev, const RequestStream* rs, const DiskResult* result) {
+    if (dev->kind == DEVICE_TRACKS) return -1;
+    if (rs->n == 0 || result->finish <= rs->arrival[0]) return 0;
+    return rs->n * 1e6 / (double)(result->finish - rs->arrival[0]);
+}
+
+/**
+ * @brief Prints total movement, the request rate (skipped when negative) and
+ *        latency mean and percentiles (sorts result->latency).
+ */
+void print_latency_row(const char* name, const DiskResult* result, int n, double rate) {
+    long long* latency = result->latency;
+    double sum = 0;
+
+    printf("%-8s\t%-8lld\t", name, result->movement);
+    if (rate >= 0) printf("%.0f\t", rate);
+    if (n == 0) {
+        printf("-\t-\t-\t-\t-\n");
+        return;
+    }
+    qsort(latency, n, sizeof(long long), compare_ll);
+    for (int i = 0; i < n; i++) sum += (double)latency[i];
+    printf("%.1f\t%lld\t%lld\t%lld\t%lld\n", sum / n,
+           latency[(long long)n * 50 / 100], latency[(long long)n * 90 / 100],
+           latency[(long long)n * 99 / 100], latency[n - 1]);
+}
@@ -0,0 +1,146 @@
+/*
+ * disk_timing.h
+ * =============
+ * Service time models for the disk simulators: how long the device takes
+ * for a request, given where the head was and when the request is issued.
+ *
+ * Devices (DeviceKind):
+ * - Tracks: one time unit per track of head movement plus a fixed transfer
+ *   time, the classic textbook measure.
+ * - HDD: seek + rotational latency + transfer, in microseconds.
+ *   - Seek: 0 for the same track, otherwise
+ *       settle + a * sqrt(x)                   for x <= knee
+ *       settle + a * sqrt(knee) + b * (x - knee) beyond it,
+ *     where x is the distance as a fraction of the full stroke (disk_size - 1
+ *     tracks). Short seeks are dominated by the arm accelerating, long ones
+ *     by coasting at full speed; 'a' and 'b' are derived so the curve is
+ *     smooth at the knee and a full stroke takes full_stroke_us.
+ *   - Rotation: each request's sector sits at a fixed angle on its track
+ *     (a hash of its index, so every algorithm sees the same layout). When
+ *     the seek ends the head waits for that angle to come around, at 'rpm'.
+ *   - Transfer: the fraction of a rotation the request covers on its track
+ *     (request_kb / track_kb).
+ * - SSD: no head. Track numbers are LBAs, striped over 'channels'
+ *   independent flash channels (LBA i on channel i % channels). A request
+ *   takes flash_us once its channel is free, and the device accepts up to
+ *   'queue_depth' requests at once, so order matters only through how well
+ *   it spreads the queue over the channels.
+ *
+ * The HDD and Tracks devices serve one request at a time.
+ *
+ * Every function is static inline so each simulator can include this header
+ * directly and still be compiled on its own.
+ */
+
+#ifndef DISK_TIMING_H
+#define DISK_TIMING_H
+
+#include <stdlib.h>
+#include <math.h>
+
+typedef enum { DEVICE_TRACKS, DEVICE_HDD, DEVICE_SSD, N_DEVICE_KINDS } DeviceKind;
+
+static const char* const device_kind_names[N_DEVICE_KINDS] = { "tracks", "hdd", "ssd" };
+
+/* Device parameters; device_defaults() fills in a 7200 RPM disk and an 8-channel SSD */
+typedef struct {
+    DeviceKind kind;
+    long long transfer;     // Tracks: time units per request once on its track
+    double settle_us;       // HDD: any nonzero seek (track to track)
+    double full_stroke_us;  // HDD: seek across the whole disk
+    double knee;            // HDD: fraction of the stroke where the seek turns linear
+    double rpm;
+    double request_kb;      // HDD: bytes per request ...
+    double track_kb;        // ... and per track (transfer = rotation * request / track)
+    double flash_us;        // SSD: one request on one channel
+    int channels;
+    int queue_depth;        // SSD: requests in flight
+} DeviceModel;
+
+/* Per-simulation device state */
+typedef struct {
+    long long *channel_free; // SSD: when each channel finishes its current request
+} DeviceState;
+
+static inline void device_defaults(DeviceModel* m, DeviceKind kind) {
+    m->kind = kind;
+    m->transfer = 1;
+    m->settle_us = 1000;
+    m->full_stroke_us = 16000;
+    m->knee = 0.3;
+    m->rpm = 7200;
+    m->request_kb = 4;
+    m->track_kb = 1024;
+    m->flash_us = 80;
+    m->channels = 8;
+    m->queue_depth = 32;
+}
+
+/**
+ * @brief Requests the device works on at once.
+ */
+static inline int device_slots(const DeviceModel* m) {
+    return (m->kind == DEVICE_SSD) ? m->queue_depth : 1;
+}
+
+static inline void device_state_init(DeviceState* st, const DeviceModel* m) {
+    st->channel_free = (long long*)calloc(m->channels > 0 ? m->channels : 1, sizeof(long long));
+}
+
+static inline void device_state_free(DeviceState* st) {
+    free(st->channel_free);
+}
+
+/**
+ * @brief HDD seek time in microseconds for a move of 'distance' tracks.
+ */
+static inline double device_seek_us(const DeviceModel* m, long long distance, long long disk_size) {
+    if (distance == 0) return 0;
+    double x = (disk_size > 1) ? (double)distance / (double)(disk_size - 1) : 1.0;
+    double k = m->knee, root_k = sqrt(k);
+    // Choose a, b: slope matches at the knee (b = a / (2 sqrt(k))) and seek(1) = full stroke.
+    double a = (m->full_stroke_us - m->settle_us) / (root_k + (1 - k) / (2 * root_k));
+    if (x <= k) return m->settle_us + a * sqrt(x);
+    return m->settle_us + a * root_k + a / (2 * root_k) * (x - k);
+}
+
+/**
+ * @brief Angle of request r's sector on its track, as a fraction of a turn.
+ */
+static inline double device_sector_angle(int r) {
+    // splitmix64 finalizer: a fixed, well spread position for every request index.
+    unsigned long long z = (unsigned long long)r * 0x9E3779B97F4A7C15ULL + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (double)(z >> 11) / 9007199254740992.0; // 53 bits -> [0, 1)
+}
+
+/**
+ * @brief Issues request r at time 'now' after the scheduler moved the head
+ *        'distance' tracks to 'track'.
+ * @return Completion time (time units for Tracks, microseconds otherwise).
+ */
+static inline long long device_dispatch(const DeviceModel* m, DeviceState* st, int r, long long track,
+                                        long long distance, long long disk_size, long long now) {
+    switch (m->kind) {
+    case DEVICE_HDD: {
+        double rotation_us = 60e6 / m->rpm;
+        double arrive = (double)now + device_seek_us(m, distance, disk_size);
+        double angle = fmod(arrive / rotation_us, 1.0);
+        double wait = fmod(device_sector_angle(r) - angle + 1.0, 1.0) * rotation_us;
+        double transfer = rotation_us * m->request_kb / m->track_kb;
+        return now + llround(arrive - (double)now + wait + transfer);
+    }
+    case DEVICE_SSD: {
+        long long* channel = &st->channel_free[track % m->channels];
+        long long start = (*channel > now) ? *channel : now;
+        *channel = start + llround(m->flash_us);
+        return *channel;
+    }
+    default:
+        return now + distance + m->transfer;
+    }
+}
+
+#endif // DISK_TIMING_H
@@ -0,0 +1,291 @@
+/*
+ * elevator_bench.c
+ * ================
+ * Measures what request ordering buys on a real file or block device: runs
+ * the same batches of reads through elevator_io.h once per scheduling policy
+ * and reports throughput and read latency for each.
+ *
+ * The batches are random block-aligned offsets over the target (or the
+ * offsets listed in a file), cut into batches of --batch requests. Before
+ * each policy the target's cached pages are dropped with
+ * posix_fadvise(DONTNEED), so every policy reads from the device; --direct
+ * opens it with O_DIRECT to bypass the page cache altogether.
+ *
+ * Usage:
+ *   ./elevator_bench TARGET [options]
+ * Options:
+ *   --reads N        total reads (default 4096)
+ *   --batch N        reads per batch handed to the elevator (default 256)
+ *   --size BYTES     bytes per read, also the offset alignment (default 4096)
+ *   --depth D        reads in flight (default 1: the device sees the elevator order)
+ *   --offsets FILE   read these offsets (one per line, in bytes) instead of random ones
+ *   --policy NAME    only FCFS, SSTF, SCAN, LOOK, C-SCAN or C-LOOK
+ *   --direct         open TARGET with O_DIRECT
+ *   --seed S         random offset seed (default 1)
+ *
+ * Compile with: gcc elevator_bench.c -o elevator_bench -pthread
+ *   (or: gcc -DHAVE_LIBURING elevator_bench.c -o elevator_bench -pthread -luring)
+ */
+
+#define _GNU_SOURCE // For O_DIRECT
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h> // For BLKGETSIZE64 on block devices
+#include "elevator_io.h" // Batch reordering and issue (io_uring or pread threads)
+
+/* Benchmark configuration */
+typedef struct {
+    const char *target;
+    const char *offsets_path;
+    int reads;
+    int batch;
+    size_t size;
+    int depth;
+    int direct;
+    unsigned int seed;
+    int policy;        // -1 = every policy
+} BenchOptions;
+
+// --- Function Prototypes ---
+int parse_options(int argc, char* argv[], BenchOptions* opts);
+long long target_size(int fd);
+long long* load_offsets(const BenchOptions* opts, long long size, int* n);
+int compare_ll(const void* a, const void* b);
+int run_policy(const BenchOptions* opts, int fd, long long size, DiskAlgorithm policy,
+               const long long offsets[], int n);
+
+int main(int argc, char* argv[]) {
+    BenchOptions opts;
+    if (parse_options(argc, argv, &opts) != 0) {
+        fprintf(stderr, "Usage: %s TARGET [--reads N] [--batch N] [--size BYTES] [--depth D]\n"
+                        "       [--offsets FILE] [--policy NAME] [--direct] [--seed S]\n", argv[0]);
+        return 1;
+    }
+
+    int fd = open(opts.target, O_RDONLY | (opts.direct ? O_DIRECT : 0));
+    if (fd < 0) {
+        perror(opts.target);
+        return 1;
+    }
+    long long size = target_size(fd);
+    if (size < (long long)opts.size) {
+        fprintf(stderr, "%s: smaller than one %zu-byte read\n", opts.target, opts.size);
+        close(fd);
+        return 1;
+    }
+
+    int n;
+    long long* offsets = load_offsets(&opts, size, &n);
+    if (offsets == NULL) {
+        close(fd);
+        return 1;
+    }
+
+    printf("\n---=== [ Elevator I/O: %s, %d reads of %zu B in batches of %d, depth %d, %s%s ] ===---\n",
+           opts.target, n, opts.size, opts.batch, opts.depth,
+#ifdef HAVE_LIBURING
+           "io_uring",
+#else
+           "pread threads",
+#endif
+           opts.direct ? ", O_DIRECT" : "");
+    printf("Policy\t\tSeek (MB)\tMB/s\t\tMean us\t\tp50 us\t\tp99 us\t\tMax us\n");
+    int status = 0;
+    for (int p = 0; p <= DISK_CLOOK; p++) {
+        if (opts.policy != -1 && opts.policy != p) continue;
+        if (run_policy(&opts, fd, size, (DiskAlgorithm)p, offsets, n) != 0) status = 1;
+    }
+    printf("Seek = total distance between consecutive offsets (head travel on a disk).\n");
+
+    free(offsets);
+    close(fd);
+    return status;
+}
+
+/**
+ * @brief Reads the command line into 'opts'.
+ * @return 0 on success, -1 on a usage error.
+ */
+int parse_options(int argc, char* argv[], BenchOptions* opts) {
+    opts->target = NULL;
+    opts->offsets_path = NULL;
+    opts->reads = 4096;
+    opts->batch = 256;
+    opts->size = 4096;
+    opts->depth = 1;
+    opts->direct = 0;
+    opts->seed = 1;
+    opts->policy = -1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reads") == 0 && i + 1 < argc) {
+            opts->reads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            opts->batch = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            opts->size = (size_t)strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--depth") == 0 && i + 1 < argc) {
+            opts->depth = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--offsets") == 0 && i + 1 < argc) {
+            opts->offsets_path = argv[++i];
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            opts->seed = (unsigned int)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--direct") == 0) {
+            opts->direct = 1;
+        } else if (strcmp(argv[i], "--policy") == 0 && i + 1 < argc) {
+            i++;
+            for (int p = 0; p <= DISK_CLOOK; p++) {
+                if (strcasecmp(argv[i], disk_algorithm_names[p]) == 0) opts->policy = p;
+            }
+            if (opts->policy == -1) return -1;
+        } else if (argv[i][0] != '-' && opts->target == NULL) {
+            opts->target = argv[i];
+        } else {
+            return -1;
+        }
+    }
+    if (opts->target == NULL || opts->reads < 1 || opts->batch < 1 || opts->size == 0 ||
+        opts->depth < 1 || opts->depth > ELEVATOR_MAX_DEPTH) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Size of a regular file or block device in bytes, -1 on error.
+ */
+long long target_size(int fd) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return -1;
+    if (S_ISBLK(st.st_mode)) {
+        unsigned long long bytes;
+        if (ioctl(fd, BLKGETSIZE64, &bytes) != 0) return -1;
+        return (long long)bytes;
+    }
+    return (long long)st.st_size;
+}
+
+/**
+ * @brief Builds the read offsets: from --offsets, or uniformly random reads
+ *        aligned to the read size anywhere in the target.
+ * @return Newly allocated offsets, or NULL on error.
+ */
+long long* load_offsets(const BenchOptions* opts, long long size, int* n) {
+    long long* offsets;
+    if (opts->offsets_path != NULL) {
+        FILE* fp = fopen(opts->offsets_path, "r");
+        int capacity = 1024;
+        long long offset;
+        if (fp == NULL) {
+            perror(opts->offsets_path);
+            return NULL;
+        }
+        offsets = (long long*)malloc(capacity * sizeof(long long));
+        *n = 0;
+        while (fscanf(fp, "%lld", &offset) == 1) {
+            if (offset < 0 || offset > size - (long long)opts->size) {
+                fprintf(stderr, "%s: offset %lld is outside the target\n", opts->offsets_path, offset);
+                fclose(fp);
+                free(offsets);
+                return NULL;
+            }
+            if (*n == capacity) {
+                capacity *= 2;
+                offsets = (long long*)realloc(offsets, capacity * sizeof(long long));
+            }
+            offsets[(*n)++] = offset;
+        }
+        fclose(fp);
+        if (*n == 0) {
+            fprintf(stderr, "%s: no offsets\n", opts->offsets_path);
+            free(offsets);
+            return NULL;
+        }
+        return offsets;
+    }
+
+    long long blocks = size / (long long)opts->size;
+    unsigned long long state = opts->seed * 0x9E3779B97F4A7C15ULL + 1;
+    offsets = (long long*)malloc(opts->reads * sizeof(long long));
+    for (int i = 0; i < opts->reads; i++) {
+        // xorshift64*: deterministic for a given seed, independent of the C library's rand().
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        offsets[i] = (long long)((state * 0x2545F4914F6CDD1DULL) % (unsigned long long)blocks) * (long long)opts->size;
+    }
+    *n = opts->reads;
+    return offsets;
+}
+
+// Comparison function for qsort to sort long longs in ascending order.
+int compare_ll(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Drops the target's cached pages, runs every batch through the
+ *        elevator with one policy and prints its row.
+ * @return 0 on success, -1 if reads failed.
+ */
+int run_policy(const BenchOptions* opts, int fd, long long size, DiskAlgorithm policy,
+               const long long offsets[], int n) {
+    Elevator e;
+    IoRequest* reqs = (IoRequest*)malloc(n * sizeof(IoRequest));
+    long long* latency = (long long*)malloc(n * sizeof(long long));
+    long long seek_total = 0, bytes = 0, failed = 0;
+    int status = 0, first_error = 0;
+
+    for (int i = 0; i < n; i++) {
+        reqs[i].offset = offsets[i];
+        reqs[i].length = opts->size;
+        reqs[i].latency_ns = 0;
+        reqs[i].result = 0;
+    }
+    if (elevator_init(&e, fd, size, opts->depth, opts->size) != 0) {
+        free(reqs);
+        free(latency);
+        return -1;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+
+    long long start = elevator_now_ns();
+    for (int first = 0; first < n && status == 0; first += opts->batch) {
+        int count = (n - first < opts->batch) ? n - first : opts->batch;
+        long long seek;
+        status = elevator_run(&e, policy, reqs + first, count, &seek);
+        seek_total += seek;
+    }
+    double seconds = (elevator_now_ns() - start) / 1e9;
+
+    for (int i = 0; i < n; i++) {
+        if (reqs[i].result < 0 && failed++ == 0) first_error = (int)-reqs[i].result;
+        else if (reqs[i].result >= 0) bytes += reqs[i].result;
+        latency[i] = reqs[i].latency_ns;
+    }
+    qsort(latency, n, sizeof(long long), compare_ll);
+    double mean = 0;
+    for (int i = 0; i < n; i++) mean += (double)latency[i];
+    mean /= n;
+
+    printf("%-8s\t%-12.1f\t%-12.2f\t%-12.1f\t%-12.1f\t%-12.1f\t%.1f\n", disk_algorithm_names[policy],
+           seek_total / 1048576.0, seconds > 0 ? bytes / 1048576.0 / seconds : 0.0, mean / 1000,
+           latency[(long long)n * 50 / 100] / 1000.0, latency[(long long)n * 99 / 100] / 1000.0,
+           latency[n - 1] / 1000.0);
+    if (failed > 0) {
+        fprintf(stderr, "%s: %lld reads failed (first error: %s)\n", disk_algorithm_names[policy], failed,
+                strerror(first_error));
+        status = -1;
+    }
+
+    elevator_free(&e);
+    free(reqs);
+    free(latency);
+    return status;
+}
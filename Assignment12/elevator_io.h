@@ -0,0 +1,259 @@
+/*
+ * elevator_io.h
+ * =============
+ * A user-space elevator: takes a batch of read requests (file offset and
+ * length), reorders it with one of the disk scheduling policies, and issues
+ * the reads against a real file or block device image.
+ *
+ * Ordering reuses disk_sched.h with byte offsets as tracks and every request
+ * pending at once, so FCFS, SSTF, SCAN, LOOK, C-SCAN and C-LOOK order a batch
+ * exactly as they order the classic track lists. The head starts where the
+ * previous batch ended; SCAN and C-SCAN sweep to offset 0 and the file end.
+ *
+ * Reads are issued in that order, keeping 'depth' of them in flight:
+ * - with HAVE_LIBURING (compile with -DHAVE_LIBURING -luring), through an
+ *   io_uring of 'depth' entries, refilled as completions arrive;
+ * - otherwise through 'depth' threads that claim the next request in order
+ *   with an atomic add and call pread.
+ * Depth 1 keeps the device seeing exactly the elevator order; larger depths
+ * let the kernel and the device reorder within the window.
+ *
+ * Each request records its latency (issue to completion, in nanoseconds)
+ * and its result (bytes read, or -errno).
+ *
+ * Every function is static inline so each program can include this header
+ * directly and still be compiled on its own.
+ */
+
+#ifndef ELEVATOR_IO_H
+#define ELEVATOR_IO_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+#include "disk_sched.h" // Scheduling policies and the pending request tree
+
+#define ELEVATOR_ALIGN 4096       // Buffer alignment, enough for O_DIRECT on common devices
+#define ELEVATOR_MAX_DEPTH 65536  // io_uring user data packs the buffer slot in 16 bits
+
+/* One read request of a batch */
+typedef struct {
+    long long offset;
+    size_t length;
+    long long latency_ns; // Issue to completion
+    long long result;     // Bytes read, or -errno
+} IoRequest;
+
+/* An open target plus the elevator state carried from batch to batch */
+typedef struct {
+    int fd;
+    long long size;       // Bytes in the file or device (SCAN/C-SCAN sweep end)
+    long long head;       // Offset after the last read, where the next batch starts
+    int depth;            // Reads kept in flight
+    size_t max_length;    // Largest read; every in-flight slot has a buffer this big
+    unsigned char **buffers;
+#ifdef HAVE_LIBURING
+    struct io_uring ring;
+#endif
+} Elevator;
+
+static inline long long elevator_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Prepares an elevator over an open descriptor.
+ * @param max_length Largest read that will be issued (buffer size per slot).
+ * @return 0 on success, -1 on error (message on stderr).
+ */
+static inline int elevator_init(Elevator* e, int fd, long long size, int depth, size_t max_length) {
+    e->fd = fd;
+    e->size = size;
+    e->head = 0;
+    e->depth = depth;
+    e->max_length = max_length;
+    e->buffers = (unsigned char**)calloc(depth, sizeof(unsigned char*));
+    for (int i = 0; i < depth; i++) {
+        void* buf = NULL;
+        if (posix_memalign(&buf, ELEVATOR_ALIGN, max_length) != 0) {
+            fprintf(stderr, "Out of memory for %d read buffers\n", depth);
+            return -1;
+        }
+        e->buffers[i] = (unsigned char*)buf;
+    }
+#ifdef HAVE_LIBURING
+    int ret = io_uring_queue_init((unsigned)depth, &e->ring, 0);
+    if (ret < 0) {
+        fprintf(stderr, "io_uring_queue_init: %s\n", strerror(-ret));
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+static inline void elevator_free(Elevator* e) {
+#ifdef HAVE_LIBURING
+    io_uring_queue_exit(&e->ring);
+#endif
+    for (int i = 0; i < e->depth; i++) free(e->buffers[i]);
+    free(e->buffers);
+}
+
+/**
+ * @brief Orders a batch with 'algorithm', starting from the elevator's head.
+ * @param order Receives request indices in issue order.
+ * @return Total seek distance in bytes (sum of offset jumps, including any
+ *         sweep to the ends of the file).
+ */
+static inline long long elevator_order(const Elevator* e, DiskAlgorithm algorithm,
+                                       const IoRequest reqs[], int n, int order[]) {
+    DiskScheduler s;
+    long long seek = 0, movement;
+    long long* arrival = (long long*)calloc(n > 0 ? n : 1, sizeof(long long)); // The whole batch at time 0
+
+    disk_init(&s, algorithm, n, arrival, e->head, e->size > 0 ? e->size : 1, 0);
+    for (int i = 0; i < n; i++) disk_add(&s, i, reqs[i].offset);
+    for (int i = 0; i < n; i++) {
+        order[i] = disk_next(&s, 0, &movement);
+        seek += movement;
+    }
+    disk_free(&s);
+    free(arrival);
+    return seek;
+}
+
+// Reads one request completely (pread may return short counts).
+static inline long long elevator_pread(int fd, unsigned char* buf, size_t length, long long offset) {
+    size_t done = 0;
+    while (done < length) {
+        ssize_t got = pread(fd, buf + done, length - done, (off_t)(offset + done));
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return -errno;
+        }
+        if (got == 0) break; // End of file
+        done += (size_t)got;
+    }
+    return (long long)done;
+}
+
+#ifndef HAVE_LIBURING
+/* State shared by the pread threads of one batch */
+typedef struct {
+    Elevator *e;
+    IoRequest *reqs;
+    const int *order;
+    int n;
+    int next;          // Next position in 'order', taken with an atomic add
+    int next_slot;     // Buffer slots handed to threads as they start
+} ElevatorBatch;
+
+/**
+ * @brief pread worker: issues requests in elevator order until none are left.
+ */
+static inline void* elevator_worker(void* arg) {
+    ElevatorBatch* b = (ElevatorBatch*)arg;
+    unsigned char* buf = b->e->buffers[__atomic_fetch_add(&b->next_slot, 1, __ATOMIC_RELAXED)];
+
+    while (1) {
+        int i = __atomic_fetch_add(&b->next, 1, __ATOMIC_RELAXED);
+        if (i >= b->n) break;
+        IoRequest* r = &b->reqs[b->order[i]];
+        long long start = elevator_now_ns();
+        r->result = elevator_pread(b->e->fd, buf, r->length, r->offset);
+        r->latency_ns = elevator_now_ns() - start;
+    }
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Issues the batch in 'order', keeping up to e->depth reads in flight,
+ *        and records each request's latency and result.
+ * @return 0 on success, -1 if the reads could not be issued (failed reads
+ *         are reported per request instead).
+ */
+static inline int elevator_issue(Elevator* e, IoRequest reqs[], const int order[], int n) {
+    if (n == 0) return 0;
+#ifdef HAVE_LIBURING
+    long long* started = (long long*)malloc(n * sizeof(long long));
+    int* free_slots = (int*)malloc(e->depth * sizeof(int));
+    int n_free = e->depth, issued = 0, completed = 0, status = 0;
+    for (int s = 0; s < e->depth; s++) free_slots[s] = e->depth - 1 - s;
+
+    while (completed < n) {
+        // Fill the ring up to 'depth' reads, in elevator order.
+        int queued = 0;
+        while (issued < n && n_free > 0) {
+            struct io_uring_sqe* sqe = io_uring_get_sqe(&e->ring);
+            if (sqe == NULL) break;
+            int r = order[issued], slot = free_slots[--n_free];
+            io_uring_prep_read(sqe, e->fd, e->buffers[slot], (unsigned)reqs[r].length, (unsigned long long)reqs[r].offset);
+            io_uring_sqe_set_data(sqe, (void*)(((uintptr_t)r << 16) | (uintptr_t)slot));
+            started[r] = elevator_now_ns();
+            issued++;
+            queued++;
+        }
+        if (queued > 0 && io_uring_submit(&e->ring) < 0) {
+            status = -1;
+            break;
+        }
+
+        struct io_uring_cqe* cqe;
+        int ret = io_uring_wait_cqe(&e->ring, &cqe);
+        if (ret < 0) {
+            if (ret == -EINTR) continue;
+            status = -1;
+            break;
+        }
+        uintptr_t data = (uintptr_t)io_uring_cqe_get_data(cqe);
+        int r = (int)(data >> 16), slot = (int)(data & 0xFFFF);
+        reqs[r].latency_ns = elevator_now_ns() - started[r];
+        reqs[r].result = cqe->res;
+        io_uring_cqe_seen(&e->ring, cqe);
+        free_slots[n_free++] = slot;
+        completed++;
+    }
+    free(started);
+    free(free_slots);
+    if (status != 0) {
+        fprintf(stderr, "io_uring submission failed\n");
+        return -1;
+    }
+#else
+    ElevatorBatch batch = { e, reqs, order, n, 0, 0 };
+    int threads = (e->depth < n) ? e->depth : n;
+    pthread_t* tids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+    for (int t = 0; t < threads; t++) pthread_create(&tids[t], NULL, elevator_worker, &batch);
+    for (int t = 0; t < threads; t++) pthread_join(tids[t], NULL);
+    free(tids);
+#endif
+    e->head = reqs[order[n - 1]].offset + (long long)reqs[order[n - 1]].length;
+    return 0;
+}
+
+/**
+ * @brief Orders and issues one batch.
+ * @param seek Receives the batch's seek distance in bytes (may be NULL).
+ * @return 0 on success, -1 on error.
+ */
+static inline int elevator_run(Elevator* e, DiskAlgorithm algorithm, IoRequest reqs[], int n, long long* seek) {
+    int* order = (int*)malloc((n > 0 ? n : 1) * sizeof(int));
+    long long distance = elevator_order(e, algorithm, reqs, n, order);
+    int status = elevator_issue(e, reqs, order, n);
+    if (seek != NULL) *seek = distance;
+    free(order);
+    return status;
+}
+
+#endif // ELEVATOR_IO_H
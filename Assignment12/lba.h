@@ -0,0 +1,114 @@
+/*
+ * lba.h
+ * =====
+ * 64-bit track numbers / LBAs for scan.c and clook.c.
+ *
+ * Tracks are unsigned 64-bit (lba_t), so any disk size fits. Head movement
+ * is summed in 128 bits: a sweep over a 64-bit disk can travel more than
+ * 2^64 tracks in total, and 128 bits cannot overflow for any batch that fits
+ * in memory.
+ *
+ * Sorting is an LSD radix sort in place of qsort. One read pass counts all
+ * eight bytes of every key at once; then each byte, least significant first,
+ * is a stable counting scatter between the array and a scratch buffer. A
+ * byte that is the same in every key is skipped, so a batch of small track
+ * numbers costs one or two scatters and even full 64-bit LBAs cost eight
+ * linear passes with no comparator calls.
+ *
+ * Every function is static inline so each simulator can include this header
+ * directly and still be compiled on its own.
+ */
+
+#ifndef LBA_H
+#define LBA_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef unsigned long long lba_t;
+typedef unsigned __int128 movement_t; // Total head movement
+
+static inline lba_t lba_distance(lba_t a, lba_t b) {
+    return a > b ? a - b : b - a;
+}
+
+/**
+ * @brief Prints a 128-bit movement total in decimal.
+ */
+static inline void print_movement(movement_t value) {
+    char digits[40];
+    int len = 0;
+    do {
+        digits[len++] = (char)('0' + (int)(value % 10));
+        value /= 10;
+    } while (value > 0);
+    while (len > 0) putchar(digits[--len]);
+}
+
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+#define RADIX_PASSES (64 / RADIX_BITS)
+#define RADIX_SMALL 64 // Shorter arrays use insertion sort
+
+static inline void insertion_sort_lba(lba_t keys[], size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        lba_t key = keys[i];
+        size_t j = i;
+        while (j > 0 && keys[j - 1] > key) {
+            keys[j] = keys[j - 1];
+            j--;
+        }
+        keys[j] = key;
+    }
+}
+
+/**
+ * @brief Sorts 'keys' in ascending order.
+ * @return 0 on success, -1 if the scratch buffer cannot be allocated.
+ */
+static inline int radix_sort_lba(lba_t keys[], size_t n) {
+    if (n < RADIX_SMALL) {
+        insertion_sort_lba(keys, n);
+        return 0;
+    }
+
+    size_t (*counts)[RADIX_BUCKETS] = calloc(RADIX_PASSES, sizeof(*counts));
+    lba_t* scratch = (lba_t*)malloc(n * sizeof(lba_t));
+    if (counts == NULL || scratch == NULL) {
+        free(counts);
+        free(scratch);
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        lba_t key = keys[i];
+        for (int p = 0; p < RADIX_PASSES; p++) counts[p][(key >> (p * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+    }
+
+    lba_t *from = keys, *to = scratch;
+    for (int p = 0; p < RADIX_PASSES; p++) {
+        int shift = p * RADIX_BITS;
+        if (counts[p][(from[0] >> shift) & (RADIX_BUCKETS - 1)] == n) continue; // Same byte everywhere
+
+        size_t offset = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            size_t count = counts[p][b];
+            counts[p][b] = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < n; i++) {
+            lba_t key = from[i];
+            to[counts[p][(key >> shift) & (RADIX_BUCKETS - 1)]++] = key;
+        }
+        lba_t* swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != keys) memcpy(keys, from, n * sizeof(lba_t));
+
+    free(counts);
+    free(scratch);
+    return 0;
+}
+
+#endif // LBA_H
@@ -13,72 +13,101 @@
  *    (e.g., towards the highest track number), servicing requests along the way.
  * 3. When it reaches the end of the disk, it reverses direction.
  * 4. It then moves towards the other end, servicing the remaining requests.
+ *
+ * Tracks are 64-bit (LBAs on disks of any size: --disk-size TRACKS, default
+ * 200), requests are sorted with an LSD radix sort, and the head movement
+ * total cannot overflow (see lba.h).
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "lba.h" // 64-bit tracks, radix sort, overflow-safe movement totals
 
-// Comparison function for qsort to sort integers in ascending order.
-int compare(const void* a, const void* b) {
-    return (*(int*)a - *(int*)b);
-}
+#define DEFAULT_DISK_SIZE 200
 
 /**
  * @brief Simulates the SCAN disk scheduling algorithm.
- * @param requests Array of track requests.
+ * @param requests Array of track requests (sorted in place).
  * @param n Number of requests.
  * @param head The initial position of the disk head.
  * @param disk_size The total number of tracks on the disk.
  */
-void run_scan(int requests[], int n, int head, int disk_size) {
-    int total_movement = 0;
-    int current_head = head;
+void run_scan(lba_t requests[], size_t n, lba_t head, lba_t disk_size) {
+    movement_t total_movement = 0;
+    lba_t current_head = head;
 
     // Sort the requests to make it easier to find the next track.
-    qsort(requests, n, sizeof(int), compare);
+    if (radix_sort_lba(requests, n) != 0) {
+        fprintf(stderr, "Out of memory sorting %zu requests\n", n);
+        return;
+    }
 
-    printf("Seek Sequence: %d", head);
+    printf("Seek Sequence: %llu", head);
 
     // --- Pass 1: Move from head towards the end of the disk (high numbers) ---
-    for (int i = 0; i < n; i++) {
+    for (size_t i = 0; i < n; i++) {
         // Service all requests that are >= the current head position.
         if (requests[i] >= current_head) {
-            total_movement += abs(requests[i] - current_head);
+            total_movement += lba_distance(requests[i], current_head);
             current_head = requests[i];
-            printf(" -> %d", current_head);
+            printf(" -> %llu", current_head);
         }
     }
 
     // The head moves to the very end of the disk.
-    total_movement += abs(disk_size - 1 - current_head);
+    total_movement += lba_distance(disk_size - 1, current_head);
     current_head = disk_size - 1;
-    printf(" -> %d", current_head);
+    printf(" -> %llu", current_head);
 
     // --- Pass 2: Move from the end back towards the start (low numbers) ---
-    for (int i = n - 1; i >= 0; i--) {
+    for (size_t i = n; i-- > 0;) {
         // Service the remaining requests (those that were < initial head).
         if (requests[i] < head) {
-            total_movement += abs(requests[i] - current_head);
+            total_movement += lba_distance(requests[i], current_head);
             current_head = requests[i];
-            printf(" -> %d", current_head);
+            printf(" -> %llu", current_head);
         }
     }
 
-    printf("\nTotal head movement: %d\n", total_movement);
+    printf("\nTotal head movement: ");
+    print_movement(total_movement);
+    printf("\n");
 }
 
-int main() {
-    int n, head;
-    int disk_size = 200; // Assuming a disk size of 200 tracks.
+int main(int argc, char* argv[]) {
+    int n;
+    lba_t head;
+    lba_t disk_size = DEFAULT_DISK_SIZE; // Tracks 0..disk_size-1; --disk-size changes it.
+
+    if (argc == 3 && strcmp(argv[1], "--disk-size") == 0) {
+        disk_size = strtoull(argv[2], NULL, 0);
+    } else if (argc != 1) {
+        fprintf(stderr, "Usage: %s [--disk-size TRACKS]\n", argv[0]);
+        return 1;
+    }
+    if (disk_size == 0) return 1;
+
     printf("Enter number of requests: ");
-    scanf("%d", &n);
+    if (scanf("%d", &n) != 1 || n < 0) return 1;
 
-    int* requests = malloc(n * sizeof(int));
+    lba_t* requests = (lba_t*)malloc((n > 0 ? n : 1) * sizeof(lba_t));
     printf("Enter requests:\n");
-    for(int i = 0; i < n; i++) scanf("%d", &requests[i]);
+    for (int i = 0; i < n; i++) {
+        if (scanf("%llu", &requests[i]) != 1 || requests[i] >= disk_size) {
+            fprintf(stderr, "Request %d is not a track in 0..%llu (see --disk-size).\n", i + 1, disk_size - 1);
+            free(requests);
+            return 1;
+        }
+    }
 
     printf("Enter head: ");
-    scanf("%d", &head);
+    if (scanf("%llu", &head) != 1 || head >= disk_size) {
+        fprintf(stderr, "The head must be a track in 0..%llu (see --disk-size).\n", disk_size - 1);
+        free(requests);
+        return 1;
+    }
+
     run_scan(requests, n, head, disk_size);
     free(requests);
     return 0;
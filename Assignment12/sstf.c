@@ -12,52 +12,98 @@
  *    that is closest.
  * 2. Move the head to that track, servicing the request.
  * 3. Repeat until all requests are serviced.
+ *
+ * The requests are sorted once and the nearest one is found on either side
+ * of the serviced run, so large queues take O(n log n) rather than O(n^2).
  */
 
 #include <stdio.h>
 #include <stdlib.h>
-#include <limits.h> // For INT_MAX
+
+/* A track request and its position in the input (ties go to the earlier one) */
+typedef struct {
+    int track;
+    int index;
+} Request;
+
+// Comparison function for qsort: by track, then by input position.
+int compare_request(const void* a, const void* b) {
+    const Request* x = (const Request*)a;
+    const Request* y = (const Request*)b;
+    if (x->track != y->track) return (x->track > y->track) - (x->track < y->track);
+    return x->index - y->index;
+}
 
 /**
  * @brief Simulates the SSTF disk scheduling algorithm.
+ *
+ * The requests are sorted once. Because the head always moves to the nearest
+ * request, the serviced requests are always one contiguous run of the sorted
+ * array around the head, so the next request is either just below that run
+ * ('left') or just above it ('right'). Each step is O(1) amortized and the
+ * whole schedule O(n log n), where rescanning every pending request was O(n^2).
+ * When both are equally far, the request entered first wins, exactly as in the
+ * rescanning version, so the seek sequence is unchanged.
+ *
  * @param requests Array of track requests.
  * @param n Number of requests.
  * @param head The initial position of the disk head.
  */
 void run_sstf(int requests[], int n, int head) {
-    int total_movement = 0;
+    long long total_movement = 0;
     int current_head = head;
-    int serviced_count = 0;
-    // 'serviced' array acts as a boolean flag to track completed requests.
-    int* serviced = (int*)calloc(n, sizeof(int)); // Initializes to all 0s
+    Request* sorted = (Request*)malloc((n > 0 ? n : 1) * sizeof(Request));
+
+    for (int i = 0; i < n; i++) {
+        sorted[i].track = requests[i];
+        sorted[i].index = i;
+    }
+    qsort(sorted, n, sizeof(Request), compare_request);
+
+    // 'right' is the first request at or above the head; everything below it is 'left'.
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (sorted[mid].track < head) lo = mid + 1;
+        else hi = mid;
+    }
+    int right = lo, left = lo - 1;
+    int left_first = left; // Lowest position holding the same track as 'left' (its earliest input)
+    while (left_first > 0 && sorted[left_first - 1].track == sorted[left].track) left_first--;
 
     printf("Seek Sequence: %d", head);
 
-    // Loop until all requests are serviced.
-    while (serviced_count < n) {
-        int min_dist = INT_MAX;
-        int next_idx = -1;
+    // Each step services every request for the nearest track; once the head is
+    // there, its duplicates are at distance 0 and would be chosen next anyway.
+    while (left >= 0 || right < n) {
+        int go_left;
+        if (right >= n) go_left = 1;
+        else if (left < 0) go_left = 0;
+        else {
+            long long left_dist = (long long)current_head - sorted[left].track;
+            long long right_dist = (long long)sorted[right].track - current_head;
+            go_left = left_dist < right_dist ||
+                      (left_dist == right_dist && sorted[left_first].index < sorted[right].index);
+        }
 
-        // Find the unserviced request closest to the current head position.
-        for (int i = 0; i < n; i++) {
-            if (!serviced[i]) {
-                int dist = abs(requests[i] - current_head);
-                if (dist < min_dist) {
-                    min_dist = dist;
-                    next_idx = i; // Store the index of the closest request
-                }
+        if (go_left) {
+            total_movement += (long long)current_head - sorted[left].track;
+            current_head = sorted[left].track;
+            for (int i = left_first; i <= left; i++) printf(" -> %d", current_head);
+            left = left_first - 1;
+            left_first = left;
+            while (left_first > 0 && sorted[left_first - 1].track == sorted[left].track) left_first--;
+        } else {
+            total_movement += (long long)sorted[right].track - current_head;
+            current_head = sorted[right].track;
+            while (right < n && sorted[right].track == current_head) {
+                printf(" -> %d", current_head);
+                right++;
             }
         }
-
-        // Service the closest request found.
-        total_movement += min_dist;
-        current_head = requests[next_idx];
-        printf(" -> %d", current_head);
-        serviced[next_idx] = 1; // Mark this request as completed.
-        serviced_count++;
     }
-    printf("\nTotal head movement: %d\n", total_movement);
-    free(serviced);
+    printf("\nTotal head movement: %lld\n", total_movement);
+    free(sorted);
 }
 
 int main() {